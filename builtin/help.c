@@ -10,51 +10,48 @@
 #include <string.h>
 #include "csh.h"
 
-static void print_cmdline(chry_shell_t *csh, const chry_syscall_t *call, uint32_t longest_name, uint32_t longest_path)
+static void print_cmdline(csh_row_t *row, const chry_syscall_t *call, uint32_t longest_name, uint32_t longest_path)
 {
-    uint16_t len = strlen(call->name);
-
-    csh_printf(csh, "  \e[32m%s\e[m", call->name);
-
-    for (int k = len; k < longest_name; k++) {
-        csh_printf(csh, " ");
-    }
-
-    csh_printf(csh, " -> ");
-
-    csh_printf(csh, "\e[36m%s\e[m", call->path);
+    csh_row_write(row, "  ", 2);
+    csh_row_cell(row, "\e[32m", call->name, longest_name);
+    csh_row_write(row, " -> ", 4);
+    csh_row_cell(row, "\e[36m", call->path, 0);
 
     if (call->usage) {
-        csh_printf(csh, " - ");
+        uint16_t len = strlen(call->path);
 
-        len = strlen(call->path);
+        csh_row_write(row, " - ", 3);
 
-        for (int k = len; k < longest_path; k++) {
-            csh_printf(csh, " ");
+        if (len < longest_path) {
+            csh_row_fill(row, ' ', longest_path - len);
         }
 
-        csh_printf(csh, call->usage);
+        csh_row_write(row, call->usage, strlen(call->usage));
     }
 
-    csh_printf(csh, "\r\n");
+    csh_row_end(row);
 }
 
 /*!< help    */
 int csh_builtin_help(int argc, char **argv)
 {
     chry_shell_t *csh = (void *)argv[argc + 1];
+    csh_row_t row;
     uint16_t longest_name;
     uint16_t longest_path;
     bool enable_function = true;
     bool enable_variable = true;
 
+    csh_row_init(&row, csh);
+
     if (argc > 1) {
         for (const chry_syscall_t *call = csh->cmd_tbl_beg; call < csh->cmd_tbl_end; call++) {
             if (!strcmp(argv[1], call->name)) {
-                print_cmdline(csh, call, 0, 0);
-                csh_printf(csh, "\r\nUsage:\r\n\r\n");
+                print_cmdline(&row, call, 0, 0);
+                csh_row_printf(&row, "\r\nUsage:\r\n\r\n");
+                csh_row_flush(&row);
                 if (call->help) {
-                    csh->rl.sput(&csh->rl, call->help, strlen(call->help));
+                    chry_readline_write(&csh->rl, call->help, strlen(call->help));
                     csh_printf(csh, "\r\n");
                 } else {
                     csh_printf(csh, "    help message not provided\r\n");
@@ -68,8 +65,8 @@ int csh_builtin_help(int argc, char **argv)
     }
 
     if (enable_function) {
-        csh_printf(csh, "total function %d\r\n",
-                   ((uintptr_t)csh->cmd_tbl_end - (uintptr_t)csh->cmd_tbl_beg) / sizeof(chry_syscall_t));
+        csh_row_printf(&row, "total function %d\r\n",
+                       ((uintptr_t)csh->cmd_tbl_end - (uintptr_t)csh->cmd_tbl_beg) / sizeof(chry_syscall_t));
     }
 
     longest_name = 0;
@@ -82,16 +79,20 @@ int csh_builtin_help(int argc, char **argv)
     }
 
     for (const chry_syscall_t *call = csh->cmd_tbl_beg; call < csh->cmd_tbl_end; call++) {
-        print_cmdline(csh, call, longest_name, longest_path);
+        if (chry_readline_pager_quit(&csh->rl)) {
+            break;
+        }
+
+        print_cmdline(&row, call, longest_name, longest_path);
     }
 
     if (enable_variable) {
         if (enable_function) {
-            csh_printf(csh, "\r\n");
+            csh_row_end(&row);
         }
 
-        csh_printf(csh, "total variable %d\r\n",
-                   ((uintptr_t)csh->var_tbl_end - (uintptr_t)csh->var_tbl_beg) / sizeof(chry_sysvar_t));
+        csh_row_printf(&row, "total variable %d\r\n",
+                       ((uintptr_t)csh->var_tbl_end - (uintptr_t)csh->var_tbl_beg) / sizeof(chry_sysvar_t));
     }
 
     longest_name = 0;
@@ -101,19 +102,16 @@ int csh_builtin_help(int argc, char **argv)
     }
 
     for (const chry_sysvar_t *var = csh->var_tbl_beg; var < csh->var_tbl_end; var++) {
-        uint16_t len = strlen(var->name);
-
-        csh_printf(csh, "  $\e[33m%s\e[m", var->name);
-
-        for (int k = len; k < longest_name; k++) {
-            csh_printf(csh, " ");
-        }
-
         char cr = var->attr & CSH_VAR_READ ? 'r' : '-';
         char cw = var->attr & CSH_VAR_WRITE ? 'w' : '-';
-        csh_printf(csh, " %c%c %3d\r\n", cr, cw, var->attr & CSH_VAR_SIZE);
+
+        csh_row_write(&row, "  $", 3);
+        csh_row_cell(&row, "\e[33m", var->name, longest_name);
+        csh_row_printf(&row, " %c%c %3d\r\n", cr, cw, var->attr & CSH_VAR_SIZE);
     }
 
+    csh_row_flush(&row);
+
     return 0;
 }
 
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2025, Egahp
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "csh.h"
+
+#if defined(CONFIG_CSH_STATS) && CONFIG_CSH_STATS
+
+/*!< keystat */
+static int keystat(int argc, char **argv)
+{
+    chry_shell_t *csh = (void *)argv[argc + 1];
+    chry_readline_t *rl = &csh->rl;
+
+    if ((argc == 2) && !strcmp(argv[1], "reset")) {
+        chry_readline_stats_reset(rl);
+        csh_printf(csh, "Key statistics cleared\r\n");
+        return 0;
+    } else if (argc != 1) {
+        CSH_CALL_HELP("keystat");
+        return -1;
+    }
+
+    if (NULL == rl->stats.stamp) {
+        csh_printf(csh, "Error: No timestamp callback, see chry_readline_set_stamp_cb\r\n");
+        return -1;
+    }
+
+    csh_printf(csh, "keys    %lu\r\n", (unsigned long)rl->stats.keys);
+    csh_printf(csh, "echoes  %lu\r\n", (unsigned long)rl->stats.echoes);
+
+    if (rl->stats.echoes == 0) {
+        return 0;
+    }
+
+    csh_printf(csh, "bytes   %lu, %lu per key\r\n",
+               (unsigned long)rl->stats.bytes,
+               (unsigned long)(rl->stats.bytes / rl->stats.echoes));
+    csh_printf(csh, "latency min %lu, avg %lu, max %lu\r\n",
+               (unsigned long)rl->stats.min,
+               (unsigned long)(rl->stats.sum / rl->stats.echoes),
+               (unsigned long)rl->stats.max);
+
+    for (uint8_t i = 0; i < CHRY_READLINE_STATS_HIST; i++) {
+        if (i < (CHRY_READLINE_STATS_HIST - 1)) {
+            csh_printf(csh, "  < %-8lu %lu\r\n", 16UL << (i * 2), (unsigned long)rl->stats.hist[i]);
+        } else {
+            csh_printf(csh, "  >=%-8lu %lu\r\n", 16UL << ((i - 1) * 2), (unsigned long)rl->stats.hist[i]);
+        }
+    }
+
+    return 0;
+}
+
+CSH_SCMD_EXPORT_FULL(
+    keystat,
+    "show key to echo latency statistics",
+    "keystat\r\n"
+    "    - show keys received, echoes measured and echo bytes per key\r\n"
+    "    - show min, avg and max key to echo latency in timestamp units\r\n"
+    "    - show latency histogram\r\n"
+    "keystat reset\r\n"
+    "    - clear statistics\r\n"
+    "keystat -h\r\n"
+    "keystat --help\r\n"
+    "    - show usage and help information\r\n");
+
+#endif
@@ -40,6 +40,7 @@ retry:
     chry_readline_mask(&csh->rl, true);
     first = csh->rl.prompt[0];
     csh->rl.prompt[0] = '\0';
+    chry_readline_prompt_dirty(&csh->rl);
 
 #if defined(CONFIG_CSH_NOBLOCK) && CONFIG_CSH_NOBLOCK
 restore:
@@ -54,6 +55,7 @@ restore:
 #endif
 
     csh->rl.prompt[0] = first;
+    chry_readline_prompt_dirty(&csh->rl);
     chry_readline_mask(&csh->rl, false);
 
     if (password == NULL) {
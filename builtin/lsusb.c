@@ -17,7 +17,7 @@
 
 extern usb_slist_t g_bus_head;
 
-static void usbh_list_device(struct usbh_hub *hub, chry_shell_t *csh, bool astree, bool verbose, int dev_addr, int vid, int pid)
+static void usbh_list_device(struct usbh_hub *hub, csh_row_t *row, bool astree, bool verbose, int dev_addr, int vid, int pid)
 {
     static const char *speed_table[] = {
         "UNKNOWN",
@@ -70,15 +70,15 @@ static void usbh_list_device(struct usbh_hub *hub, chry_shell_t *csh, bool astre
 
     if (hub->is_roothub) {
         if (astree) {
-            csh_printf(csh, "/:  Bus %02u.Port 1: Dev %u, Class=root_hub, Driver=hcd, %uM\r\n",
-                       bus->busid, hub->hub_addr, speed_baud[hub->speed]);
+            csh_row_printf(row, "/:  Bus %02u.Port 1: Dev %u, Class=root_hub, Driver=hcd, %uM\r\n",
+                           bus->busid, hub->hub_addr, speed_baud[hub->speed]);
 
         } else {
             if ((dev_addr < 0) || (hub->hub_addr == dev_addr)) {
                 if (((vid < 0) || (vid == 0xffff)) && ((pid < 0) || (pid == 0xffff))) {
-                    csh_printf(csh, "Bus %03u Device %03u: ID %04x:%04x %s %s root hub\r\n",
-                               bus->busid, hub->hub_addr, 0xffff, 0xffff,
-                               "Cherry-Embedded", root_speed_table[hub->speed]);
+                    csh_row_printf(row, "Bus %03u Device %03u: ID %04x:%04x %s %s root hub\r\n",
+                                   bus->busid, hub->hub_addr, 0xffff, 0xffff,
+                                   "Cherry-Embedded", root_speed_table[hub->speed]);
                 }
             }
         }
@@ -119,9 +119,9 @@ static void usbh_list_device(struct usbh_hub *hub, chry_shell_t *csh, bool astre
             if (!astree) {
                 if ((dev_addr < 0) || (hport->dev_addr == dev_addr)) {
                     if (((vid < 0) || (vid == hport->device_desc.idVendor)) && ((pid < 0) || (pid == hport->device_desc.idProduct))) {
-                        csh_printf(csh, "Bus %03u Device %03u: ID %04x:%04x %s %s\r\n",
-                                   bus->busid, hport->dev_addr, hport->device_desc.idVendor, hport->device_desc.idProduct,
-                                   pimstr, pipstr);
+                        csh_row_printf(row, "Bus %03u Device %03u: ID %04x:%04x %s %s\r\n",
+                                       bus->busid, hport->dev_addr, hport->device_desc.idVendor, hport->device_desc.idProduct,
+                                       pimstr, pipstr);
                     }
                 }
             }
@@ -129,28 +129,22 @@ static void usbh_list_device(struct usbh_hub *hub, chry_shell_t *csh, bool astre
             for (uint8_t intf = 0; intf < hport->config.config_desc.bNumInterfaces; intf++) {
                 if (hport->config.intf[intf].class_driver && hport->config.intf[intf].class_driver->driver_name) {
                     if (astree) {
-                        for (uint8_t j = 0; j < hub->index; j++) {
-                            csh_printf(csh, "    ");
-                        }
-
-                        csh_printf(csh, "|__ Port %u: Dev %u, If %u, ClassDriver=%s, %uM\r\n",
-                                   hport->port, hport->dev_addr, intf, hport->config.intf[intf].class_driver->driver_name, speed_baud[hport->speed]);
+                        csh_row_fill(row, ' ', 4 * hub->index);
+                        csh_row_printf(row, "|__ Port %u: Dev %u, If %u, ClassDriver=%s, %uM\r\n",
+                                       hport->port, hport->dev_addr, intf, hport->config.intf[intf].class_driver->driver_name, speed_baud[hport->speed]);
                     }
 
                     if (!strcmp(hport->config.intf[intf].class_driver->driver_name, "hub")) {
                         hub_next = hport->config.intf[intf].priv;
 
                         if (hub_next && hub_next->connected) {
-                            usbh_list_device(hub_next, csh, astree, verbose, dev_addr, vid, pid);
+                            usbh_list_device(hub_next, row, astree, verbose, dev_addr, vid, pid);
                         }
                     }
                 } else if (astree) {
-                    for (uint8_t j = 0; j < hub->index; j++) {
-                        csh_printf(csh, "    ");
-                    }
-
-                    csh_printf(csh, "|__ Port %u: Dev %u, If 0 ClassDriver=none, %uM\r\n",
-                               hport->port, hport->dev_addr, speed_baud[hport->speed]);
+                    csh_row_fill(row, ' ', 4 * hub->index);
+                    csh_row_printf(row, "|__ Port %u: Dev %u, If 0 ClassDriver=none, %uM\r\n",
+                                   hport->port, hport->dev_addr, speed_baud[hport->speed]);
                 }
             }
         }
@@ -162,6 +156,7 @@ int csh_lsusb(int argc, char **argv)
     chry_shell_t *csh = (void *)argv[argc + 1];
     usb_slist_t *bus_list;
     struct usbh_bus *bus;
+    csh_row_t row;
 
     int busid = -1;
     int dev_addr = -1;
@@ -258,6 +253,8 @@ int csh_lsusb(int argc, char **argv)
         verbose = false;
     }
 
+    csh_row_init(&row, csh);
+
     usb_slist_for_each(bus_list, &g_bus_head)
     {
         bus = usb_slist_entry(bus_list, struct usbh_bus, list);
@@ -267,9 +264,11 @@ int csh_lsusb(int argc, char **argv)
             }
         }
 
-        usbh_list_device(&bus->hcd.roothub, csh, astree, verbose, dev_addr, vid, pid);
+        usbh_list_device(&bus->hcd.roothub, &row, astree, verbose, dev_addr, vid, pid);
     }
 
+    csh_row_flush(&row);
+
     return 0;
 }
 
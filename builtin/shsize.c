@@ -17,7 +17,7 @@ static int shsize(int argc, char **argv)
     chry_shell_t *csh = (void *)argv[argc + 1];
 
     if ((argc == 2) && !strcmp(argv[1], "update")) {
-        if (5 != csh->rl.sput(&csh->rl, "\e[18t", 5)) {
+        if (5 != chry_readline_write(&csh->rl, "\e[18t", 5)) {
             csh_printf(csh, "Error: Failed to request window size update\r\n");
             return -1;
         }
@@ -21,17 +21,69 @@
 #endif
 #endif
 
-#define chry_readline_waitkey(__rl, __c)            \
-    do {                                            \
-        while (0 == (__rl)->sget((__rl), (__c), 1)) \
-            ;                                       \
+#if defined(CONFIG_READLINE_INBUFF) && CONFIG_READLINE_INBUFF
+/*!< one byte from inbuff, refilled by one sget call when empty */
+#define chry_readline_rdget(__rl, __c) chry_readline_inget((__rl), (__c))
+#else
+#define chry_readline_rdget(__rl, __c) (__rl)->sget((__rl), (__c), 1)
+#endif
+
+#if defined(CONFIG_READLINE_PEEK) && CONFIG_READLINE_PEEK
+/*!< one byte read in place from port ring when peek callback is set */
+#define chry_readline_sget0(__rl, __c) \
+    ((__rl)->peek.speek ? chry_readline_pkget((__rl), (__c)) : chry_readline_rdget((__rl), (__c)))
+#else
+#define chry_readline_sget0 chry_readline_rdget
+#endif
+
+#if defined(CONFIG_READLINE_NOBLOCK) && CONFIG_READLINE_NOBLOCK
+/*!< one byte from pushed input while feeding, sget is not called */
+#define chry_readline_sget1(__rl, __c) \
+    ((__rl)->feed.data ? chry_readline_fdget((__rl), (__c)) : chry_readline_sget0((__rl), (__c)))
+#else
+#define chry_readline_sget1 chry_readline_sget0
+#endif
+
+#if defined(CONFIG_READLINE_TYPEAHEAD) && CONFIG_READLINE_TYPEAHEAD
+/*!< typeahead kept in ignore mode is replayed before new input */
+#define chry_readline_sget2(__rl, __c)                          \
+    ((!(__rl)->ignore && ((__rl)->tah.in != (__rl)->tah.out)) ? \
+         chry_readline_taget((__rl), (__c)) :                   \
+         chry_readline_sget1((__rl), (__c)))
+#else
+#define chry_readline_sget2 chry_readline_sget1
+#endif
+
+#if defined(CONFIG_READLINE_TXQUEUE) && CONFIG_READLINE_TXQUEUE
+/*!< no input, retry queued output, only sleep forever once it is all sent */
+#define chry_readline_waitkey(__rl, __c)                                       \
+    do {                                                                       \
+        while (0 == chry_readline_sget2((__rl), (__c))) {                      \
+            uint32_t _timeout_ = chry_readline_txflush(__rl) ?                 \
+                                     CHRY_READLINE_WAIT_TXRETRY :              \
+                                     CHRY_READLINE_WAIT_FOREVER;               \
+            if ((__rl)->wait) {                                                \
+                (__rl)->wait((__rl), _timeout_);                               \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
+#else
+/*!< no input, sleep in port wait callback instead of spinning on sget */
+#define chry_readline_waitkey(__rl, __c)                          \
+    do {                                                          \
+        while (0 == chry_readline_sget2((__rl), (__c))) {         \
+            if ((__rl)->wait) {                                   \
+                (__rl)->wait((__rl), CHRY_READLINE_WAIT_FOREVER); \
+            }                                                     \
+        }                                                         \
     } while (0)
+#endif
 
 #if defined(CONFIG_READLINE_NOBLOCK) && CONFIG_READLINE_NOBLOCK
 
-#define chry_readline_getkey(__rl, __c)                        \
-    do {                                                       \
-        (__rl)->noblock = 0 == (__rl)->sget((__rl), (__c), 1); \
+#define chry_readline_getkey(__rl, __c)                            \
+    do {                                                           \
+        (__rl)->noblock = 0 == chry_readline_sget2((__rl), (__c)); \
     } while (0)
 
 #else
@@ -49,9 +101,57 @@
         }                                        \
     } while (0)
 
+#else
+
+#define CHRY_READLINE_PARAM_CHECK(__expr, __ret) ((void)0)
+
+#endif
+
+#if defined(CONFIG_READLINE_STATS) && CONFIG_READLINE_STATS
+
+/*!< count echo bytes while a key waits for its echo */
+#define chry_readline_stats_tx(__rl, __size) \
+    do {                                     \
+        if ((__rl)->stats.wait) {            \
+            (__rl)->stats.nbyte += (__size); \
+        }                                    \
+    } while (0)
+
+#else
+
+#define chry_readline_stats_tx(__rl, __size) ((void)0)
+
+#endif
+
+#if defined(CONFIG_READLINE_LEAN) && CONFIG_READLINE_LEAN
+
+/*!< prompt no longer the last output */
+#define chry_readline_undrawn(__rl) ((__rl)->drawn = 0)
+
+#else
+
+#define chry_readline_undrawn(__rl) ((void)0)
+
+#endif
+
+#if defined(CONFIG_READLINE_TXQUEUE) && CONFIG_READLINE_TXQUEUE
+
+/*!< short write is kept in txqueue, never fails */
+#define chry_readline_put(__rl, __pbuf, __size, __ret) \
+    do {                                               \
+        uint16_t _size_ = (__size);                    \
+        chry_readline_undrawn(__rl);                   \
+        chry_readline_stats_tx((__rl), _size_);        \
+        chry_readline_txput((__rl), (__pbuf), _size_); \
+    } while (0)
+
+#elif defined(CONFIG_READLINE_DEBUG) && CONFIG_READLINE_DEBUG
+
 #define chry_readline_put(__rl, __pbuf, __size, __ret)          \
     do {                                                        \
         uint16_t _size_ = (__size);                             \
+        chry_readline_undrawn(__rl);                            \
+        chry_readline_stats_tx((__rl), _size_);                 \
         if (_size_ != (__rl)->sput((__rl), (__pbuf), _size_)) { \
             return __ret;                                       \
         }                                                       \
@@ -59,15 +159,234 @@
 
 #else
 
-#define CHRY_READLINE_PARAM_CHECK(__expr, __ret) ((void)0)
-
 #define chry_readline_put(__rl, __pbuf, __size, __ret) \
     do {                                               \
-        (__rl)->sput((__rl), (__pbuf), (__size));      \
+        uint16_t _size_ = (__size);                    \
+        chry_readline_undrawn(__rl);                   \
+        chry_readline_stats_tx((__rl), _size_);        \
+        (__rl)->sput((__rl), (__pbuf), _size_);        \
     } while (0)
 
 #endif
 
+#if defined(CONFIG_READLINE_TXQUEUE) && CONFIG_READLINE_TXQUEUE
+/*****************************************************************************
+* @brief        retry queued bytes, stop at the first short write
+*
+* @param[in]    rl          readline instance
+*
+* @retval                   bytes still queued
+*****************************************************************************/
+static uint16_t chry_readline_txflush(chry_readline_t *rl)
+{
+    uint16_t offset;
+    uint16_t size;
+    uint16_t ret;
+
+    while (rl->txq.in != rl->txq.out) {
+        /*!< txqueue read offset */
+        offset = rl->txq.out & (CONFIG_READLINE_TXQUEUE - 1);
+
+        /*!< used size before ringloop */
+        size = rl->txq.in - rl->txq.out;
+        size = size > (CONFIG_READLINE_TXQUEUE - offset) ? (CONFIG_READLINE_TXQUEUE - offset) : size;
+
+        ret = rl->sput(rl, &rl->txq.pbuf[offset], size);
+        rl->txq.out += ret;
+
+        if (ret != size) {
+            break;
+        }
+    }
+
+    return rl->txq.in - rl->txq.out;
+}
+
+/*****************************************************************************
+* @brief        output data, bytes not accepted by sput are queued
+*
+* @param[in]    rl          readline instance
+* @param[in]    data        data pointer
+* @param[in]    size        data size
+*
+*****************************************************************************/
+static void chry_readline_txput(chry_readline_t *rl, const void *data, uint16_t size)
+{
+    const uint8_t *pdata = data;
+    uint16_t offset;
+    uint16_t unused;
+    uint16_t ret;
+
+    /*!< bypass txqueue only when it is empty, keep output order */
+    if (0 == chry_readline_txflush(rl)) {
+        ret = rl->sput(rl, pdata, size);
+        pdata += ret;
+        size -= ret;
+    }
+
+    while (size) {
+        /*!< txqueue unused size */
+        unused = CONFIG_READLINE_TXQUEUE - (uint16_t)(rl->txq.in - rl->txq.out);
+
+        if (unused == 0) {
+            /*!< txqueue full, wait for sput to accept something */
+            chry_readline_txflush(rl);
+            continue;
+        }
+
+        /*!< txqueue write offset */
+        offset = rl->txq.in & (CONFIG_READLINE_TXQUEUE - 1);
+
+        /*!< unused size before ringloop */
+        unused = unused > (CONFIG_READLINE_TXQUEUE - offset) ? (CONFIG_READLINE_TXQUEUE - offset) : unused;
+        unused = unused > size ? size : unused;
+
+        memcpy(&rl->txq.pbuf[offset], pdata, unused);
+        rl->txq.in += unused;
+        pdata += unused;
+        size -= unused;
+    }
+}
+#endif
+
+#if defined(CONFIG_READLINE_INBUFF) && CONFIG_READLINE_INBUFF
+/*****************************************************************************
+* @brief        get one byte from inbuff, refill with a single sget when empty
+*
+* @param[in]    rl          readline instance
+* @param[out]   c           byte pointer
+*
+* @retval                   1:got byte 0:no input
+*****************************************************************************/
+static uint16_t chry_readline_inget(chry_readline_t *rl, void *c)
+{
+    if (rl->inb.pos >= rl->inb.len) {
+        rl->inb.pos = 0;
+        rl->inb.len = rl->sget(rl, rl->inb.pbuf, CONFIG_READLINE_INBUFF);
+
+        if (rl->inb.len == 0) {
+            return 0;
+        }
+    }
+
+    *(uint8_t *)c = rl->inb.pbuf[rl->inb.pos++];
+    return 1;
+}
+#endif
+
+#if defined(CONFIG_READLINE_PEEK) && CONFIG_READLINE_PEEK
+/*****************************************************************************
+* @brief        get one byte in place from peeked region, the whole region
+*               is committed back to port once used up
+*
+* @param[in]    rl          readline instance
+* @param[out]   c           byte pointer
+*
+* @retval                   1:got byte 0:no input
+*****************************************************************************/
+static uint16_t chry_readline_pkget(chry_readline_t *rl, void *c)
+{
+    if (rl->peek.pos >= rl->peek.len) {
+        rl->peek.pos = 0;
+        rl->peek.len = 0;
+        rl->peek.pdata = rl->peek.speek(rl, &rl->peek.len);
+
+        if ((NULL == rl->peek.pdata) || (rl->peek.len == 0)) {
+            rl->peek.len = 0;
+            return 0;
+        }
+    }
+
+    *(uint8_t *)c = rl->peek.pdata[rl->peek.pos++];
+
+    if (rl->peek.pos >= rl->peek.len) {
+        /*!< release in bulk, port ring may reuse the region from now */
+        rl->peek.scommit(rl, rl->peek.len);
+    }
+
+    return 1;
+}
+#endif
+
+#if defined(CONFIG_READLINE_NOBLOCK) && CONFIG_READLINE_NOBLOCK
+/*****************************************************************************
+* @brief        get one byte from pushed input
+*
+* @param[in]    rl          readline instance
+* @param[out]   c           byte pointer
+*
+* @retval                   1:got byte 0:pushed input used up
+*****************************************************************************/
+static uint16_t chry_readline_fdget(chry_readline_t *rl, void *c)
+{
+    if (rl->feed.pos >= rl->feed.size) {
+        return 0;
+    }
+
+    *(uint8_t *)c = rl->feed.data[rl->feed.pos++];
+    return 1;
+}
+#endif
+
+#if defined(CONFIG_READLINE_TYPEAHEAD) && CONFIG_READLINE_TYPEAHEAD
+/*****************************************************************************
+* @brief        get one byte from typeahead queue
+*
+* @param[in]    rl          readline instance
+* @param[out]   c           byte pointer
+*
+* @retval                   1:got byte
+*****************************************************************************/
+static uint16_t chry_readline_taget(chry_readline_t *rl, void *c)
+{
+    *(uint8_t *)c = rl->tah.pbuf[rl->tah.out & (CONFIG_READLINE_TYPEAHEAD - 1)];
+    rl->tah.out++;
+    return 1;
+}
+#endif
+
+#if defined(CONFIG_READLINE_BATCH) && CONFIG_READLINE_BATCH
+/*****************************************************************************
+* @brief        check for pending input without consuming it
+*
+* @param[in]    rl          readline instance
+*
+* @retval                   1:input pending 0:no input or no hint
+*****************************************************************************/
+static uint8_t chry_readline_pending(chry_readline_t *rl)
+{
+#if defined(CONFIG_READLINE_TYPEAHEAD) && CONFIG_READLINE_TYPEAHEAD
+    if (!rl->ignore && (rl->tah.in != rl->tah.out)) {
+        return 1;
+    }
+#endif
+
+#if defined(CONFIG_READLINE_NOBLOCK) && CONFIG_READLINE_NOBLOCK
+    if (rl->feed.data) {
+        return rl->feed.pos < rl->feed.size;
+    }
+#endif
+
+#if defined(CONFIG_READLINE_INBUFF) && CONFIG_READLINE_INBUFF
+    if (rl->inb.pos < rl->inb.len) {
+        return 1;
+    }
+#endif
+
+#if defined(CONFIG_READLINE_PEEK) && CONFIG_READLINE_PEEK
+    if (rl->peek.pos < rl->peek.len) {
+        return 1;
+    }
+#endif
+
+    if (rl->batch.savail) {
+        return rl->batch.savail(rl) != 0;
+    }
+
+    return 0;
+}
+#endif
+
 #define chry_readline_seqgen_ris chry_readline_seqgen_reset
 #define chry_readline_seqgen_cuu chry_readline_seqgen_cursor_up
 #define chry_readline_seqgen_cud chry_readline_seqgen_cursor_down
@@ -91,6 +410,17 @@
 #define chry_readline_seqgen_asb chry_readline_seqgen_alternate_screen
 #define chry_readline_seqgen_rss chry_readline_seqgen_report_screen_size
 
+/*!< pre-encoded fixed sequences, only parameter digits are generated at runtime */
+#define CHRY_READLINE_SEQ_CHA0 "\e[0G" /*!< cursor absolute 0   */
+#define CHRY_READLINE_SEQ_ED0  "\e[0J" /*!< erase display below */
+
+/*!< sequence decoder state, kept in rl->seq between calls */
+#define CHRY_READLINE_DEC_IDLE  0 /*!< no sequence            */
+#define CHRY_READLINE_DEC_ESC   1 /*!< got esc                */
+#define CHRY_READLINE_DEC_CSI   2 /*!< got esc [              */
+#define CHRY_READLINE_DEC_SS3   3 /*!< got esc O              */
+#define CHRY_READLINE_DEC_PASTE 4 /*!< inside bracketed paste */
+
 static const uint8_t vtmap[25] = {
     CHRY_READLINE_EXEC_NUL,  /*!< 0           */
     CHRY_READLINE_EXEC_MVHM, /*!< 1  home     */
@@ -165,7 +495,11 @@ static uint8_t ctrlmap[32] = {
     CHRY_READLINE_EXEC_NLN,     /*!< O SI  */
     CHRY_READLINE_EXEC_PRVH,    /*!< P DLE */
     CHRY_READLINE_EXEC_SIGCONT, /*!< Q DC1 */
+#if defined(CONFIG_READLINE_HISTORY) && CONFIG_READLINE_HISTORY && defined(CONFIG_READLINE_HISTORY_SEARCH) && CONFIG_READLINE_HISTORY_SEARCH
+    CHRY_READLINE_EXEC_SRCH,    /*!< R DC2 */
+#else
     CHRY_READLINE_EXEC_NUL,     /*!< R DC2 */
+#endif
     CHRY_READLINE_EXEC_SIGSTOP, /*!< S DC3 */
     CHRY_READLINE_EXEC_NUL,     /*!< T DC4 */
     CHRY_READLINE_EXEC_DHLN,    /*!< U NAK */
@@ -242,31 +576,20 @@ static void chry_readline_print_integer(uint8_t *buf, size_t *idx, uint16_t valu
 }
 
 /*****************************************************************************
-* @brief        parse decimal integer (0 - 65535)
-*
-* @param[in]    buf         parse buf
-* @param[out]   value       16bit unsigned integer pointer
-*
+* @brief        output pre-encoded constant sequence (string literal only)
 *****************************************************************************/
-static void chry_readline_parse_integer(uint8_t *buf, uint16_t *value)
-{
-    *value = 0;
-
-    while (('0' <= *buf) && (*buf <= '9')) {
-        *value *= 10;
-        *value += *buf - '0';
-        buf++;
-    }
-}
+#define chry_readline_seqgen_const(buf, idx, seq)                  \
+    do {                                                           \
+        memcpy(&((uint8_t *)(buf))[*(idx)], seq, sizeof(seq) - 1); \
+        *(idx) += sizeof(seq) - 1;                                 \
+    } while (0)
 
 /*****************************************************************************
 * @brief        Reset to Initial State
 *****************************************************************************/
 __unused static void chry_readline_seqgen_reset(uint8_t *buf, size_t *idx)
 {
-    buf[*idx + 0] = '\e';
-    buf[*idx + 1] = 'c';
-    *idx += 2;
+    chry_readline_seqgen_const(buf, idx, "\ec");
 }
 
 /*****************************************************************************
@@ -274,9 +597,7 @@ __unused static void chry_readline_seqgen_reset(uint8_t *buf, size_t *idx)
 *****************************************************************************/
 __unused static void chry_readline_seqgen_csi(uint8_t *buf, size_t *idx)
 {
-    buf[*idx + 0] = '\e';
-    buf[*idx + 1] = '[';
-    *idx += 2;
+    chry_readline_seqgen_const(buf, idx, "\e[");
 }
 
 /*****************************************************************************
@@ -480,12 +801,7 @@ __unused static void chry_readline_seqgen_restore_cursor_position(uint8_t *buf,
 *****************************************************************************/
 __unused static void chry_readline_seqgen_alternate_screen(uint8_t *buf, size_t *idx)
 {
-    chry_readline_seqgen_csi(buf, idx);
-    buf[(*idx) + 0] = '?';
-    buf[(*idx) + 1] = '4';
-    buf[(*idx) + 2] = '7';
-    buf[(*idx) + 3] = 'h';
-    (*idx) += 4;
+    chry_readline_seqgen_const(buf, idx, "\e[?47h");
 }
 
 /*****************************************************************************
@@ -493,12 +809,7 @@ __unused static void chry_readline_seqgen_alternate_screen(uint8_t *buf, size_t
 *****************************************************************************/
 __unused static void chry_readline_seqgen_normal_screen(uint8_t *buf, size_t *idx)
 {
-    chry_readline_seqgen_csi(buf, idx);
-    buf[(*idx) + 0] = '?';
-    buf[(*idx) + 1] = '4';
-    buf[(*idx) + 2] = '7';
-    buf[(*idx) + 3] = 'l';
-    (*idx) += 4;
+    chry_readline_seqgen_const(buf, idx, "\e[?47l");
 }
 
 /*****************************************************************************
@@ -507,11 +818,7 @@ __unused static void chry_readline_seqgen_normal_screen(uint8_t *buf, size_t *id
 *****************************************************************************/
 __unused static void chry_readline_seqgen_report_screen_size(uint8_t *buf, size_t *idx)
 {
-    chry_readline_seqgen_csi(buf, idx);
-    buf[(*idx) + 0] = '1';
-    buf[(*idx) + 1] = '8';
-    buf[(*idx) + 2] = 't';
-    (*idx) += 3;
+    chry_readline_seqgen_const(buf, idx, "\e[18t");
 }
 
 /*****************************************************************************
@@ -530,6 +837,18 @@ int chry_readline_edit_refresh(chry_readline_t *rl)
     char *linebuff;
     uint16_t linesize;
 
+#if defined(CONFIG_READLINE_BATCH) && CONFIG_READLINE_BATCH
+    if (rl->batch.defer && (rl->batch.count < CONFIG_READLINE_BATCH) && chry_readline_pending(rl)) {
+        /*!< more keys are waiting, redraw once they are applied */
+        rl->batch.count++;
+        rl->batch.dirty = 1;
+        return 0;
+    }
+
+    rl->batch.count = 0;
+    rl->batch.dirty = 0;
+#endif
+
     linebuff = rl->ln.buff->pbuf;
 
     if (rl->ln.buff == NULL) {
@@ -553,19 +872,29 @@ int chry_readline_edit_refresh(chry_readline_t *rl)
         linesize -= (pptoff + linesize) - rl->term.col;
     }
 
-    linebuff[linesize] = '\0';
-
     idx = 0;
 
 #if defined(CONFIG_READLINE_REFRESH_PROMPT) && CONFIG_READLINE_REFRESH_PROMPT
-    /*!< move to line start */
-    chry_readline_seqgen_cursor_absolute(seq, &idx, 0);
-    chry_readline_put(rl, seq, idx, -1);
-    /*!< output prompt */
-    chry_readline_put(rl, rl->prompt, rl->ln.pptlen, -1);
+#if defined(CONFIG_READLINE_LEAN) && CONFIG_READLINE_LEAN
+    if (rl->lean && rl->drawn) {
+        /*!< prompt is still on screen, move to prompt end */
+        chry_readline_seqgen_csi(seq, &idx);
+        chry_readline_print_integer(seq, &idx, pptoff + 1);
+        seq[idx++] = 'G';
+        chry_readline_put(rl, seq, idx, -1);
+    } else
+#endif
+    {
+        /*!< move to line start */
+        chry_readline_put(rl, CHRY_READLINE_SEQ_CHA0, sizeof(CHRY_READLINE_SEQ_CHA0) - 1, -1);
+        /*!< output prompt */
+        chry_readline_put(rl, rl->prompt, rl->ln.pptlen, -1);
+    }
 #else
     /*!< move to prompt end */
-    chry_readline_seqgen_cursor_absolute(seq, &idx, pptoff + 1);
+    chry_readline_seqgen_csi(seq, &idx);
+    chry_readline_print_integer(seq, &idx, pptoff + 1);
+    seq[idx++] = 'G';
     chry_readline_put(rl, seq, idx, -1);
 #endif
 
@@ -576,10 +905,16 @@ int chry_readline_edit_refresh(chry_readline_t *rl)
 
     /*!< erase to end of display and restore cursor */
     idx = 0;
-    chry_readline_seqgen_erase_display(seq, &idx, 0);
-    chry_readline_seqgen_cursor_absolute(seq, &idx, pptoff + curoff + 1);
+    chry_readline_seqgen_const(seq, &idx, CHRY_READLINE_SEQ_ED0 "\e[");
+    chry_readline_print_integer(seq, &idx, pptoff + curoff + 1);
+    seq[idx++] = 'G';
     chry_readline_put(rl, seq, idx, -1);
 
+#if defined(CONFIG_READLINE_LEAN) && CONFIG_READLINE_LEAN
+    /*!< cleared again by any other output */
+    rl->drawn = 1;
+#endif
+
     return 0;
 }
 
@@ -588,20 +923,61 @@ int chry_readline_edit_refresh(chry_readline_t *rl)
 *****************************************************************************/
 void chry_readline_erase_line(chry_readline_t *rl)
 {
-    size_t idx;
-    uint8_t seq[16];
-
-    idx = 0;
-
     /*!< move to line start */
-    chry_readline_seqgen_cursor_absolute(seq, &idx, 0);
-    chry_readline_put(rl, seq, idx, );
+    chry_readline_put(rl, CHRY_READLINE_SEQ_CHA0, sizeof(CHRY_READLINE_SEQ_CHA0) - 1, );
 
     /*!< erase to end of display and restore cursor */
-    idx = 0;
-    chry_readline_seqgen_erase_display(seq, &idx, 0);
-    chry_readline_seqgen_cursor_absolute(seq, &idx, 0);
-    chry_readline_put(rl, seq, idx, );
+    chry_readline_put(rl, CHRY_READLINE_SEQ_ED0 CHRY_READLINE_SEQ_CHA0, sizeof(CHRY_READLINE_SEQ_ED0 CHRY_READLINE_SEQ_CHA0) - 1, );
+}
+
+/*****************************************************************************
+* @brief        enable or disable pager for following writes,
+*               enable before command output and disable after it
+*
+* @param[in]    rl          readline instance
+* @param[in]    enable      pager enable
+*
+*****************************************************************************/
+void chry_readline_pager(chry_readline_t *rl, uint8_t enable)
+{
+    CHRY_READLINE_PARAM_CHECK(NULL != rl, );
+
+#if defined(CONFIG_READLINE_PAGER) && CONFIG_READLINE_PAGER
+    if (!enable && rl->pager.enable && rl->pager.search && !rl->pager.quit) {
+        chry_readline_put(rl, "Pattern not found" CONFIG_READLINE_NEWLINE, sizeof("Pattern not found" CONFIG_READLINE_NEWLINE) - 1, );
+    }
+
+    rl->pager.enable = enable;
+    rl->pager.quit = 0;
+    rl->pager.search = 0;
+    rl->pager.esc = 0;
+    rl->pager.line = 0;
+    rl->pager.col = 0;
+    rl->pager.lnlen = 0;
+#else
+    (void)rl;
+    (void)enable;
+#endif
+}
+
+/*****************************************************************************
+* @brief        check if the rest of output has been discarded by pager,
+*               long running output loops can stop early
+*
+* @param[in]    rl          readline instance
+*
+* @retval                   1 if discarded
+*****************************************************************************/
+uint8_t chry_readline_pager_quit(chry_readline_t *rl)
+{
+    CHRY_READLINE_PARAM_CHECK(NULL != rl, 0);
+
+#if defined(CONFIG_READLINE_PAGER) && CONFIG_READLINE_PAGER
+    return rl->pager.quit;
+#else
+    (void)rl;
+    return 0;
+#endif
 }
 
 /*****************************************************************************
@@ -642,42 +1018,125 @@ int chry_readline_edit_insert(chry_readline_t *rl, char c)
     return 0;
 }
 
+#if defined(CONFIG_READLINE_PASTE) && CONFIG_READLINE_PASTE
 /*****************************************************************************
-* @brief        delete cursor left character
-* @retval int               0:Success -1:Error
+* @brief        start bracketed paste, move tail to buffer end once,
+*               pasted text fills the gap until \e[201~
 *****************************************************************************/
-int chry_readline_edit_backspace(chry_readline_t *rl)
+static void chry_readline_paste_begin(chry_readline_t *rl)
 {
-    if ((rl->ln.curoff > 0) && (rl->ln.buff->size > 0)) {
-        memmove(rl->ln.buff->pbuf + rl->ln.curoff - 1,
-                rl->ln.buff->pbuf + rl->ln.curoff,
-                rl->ln.buff->size - rl->ln.curoff);
-        rl->ln.buff->size--;
-        rl->ln.curoff--;
-        return chry_readline_edit_refresh(rl);
+    rl->paste.match = 0;
+    rl->paste.drop = rl->ignore;
+
+    if (rl->paste.drop) {
+        /*!< line buffer may be in use, only consume the paste */
+        rl->paste.tail = 0;
+        rl->paste.gap = 0;
+        rl->paste.pos = 0;
+    } else {
+        rl->paste.tail = rl->ln.buff->size - rl->ln.curoff;
+        rl->paste.gap = rl->ln.lnmax - rl->paste.tail;
+        rl->paste.pos = rl->ln.curoff;
+        memmove(rl->ln.buff->pbuf + rl->paste.gap, rl->ln.buff->pbuf + rl->paste.pos, rl->paste.tail);
     }
-    return 0;
+
+    rl->seq.state = CHRY_READLINE_DEC_PASTE;
 }
 
 /*****************************************************************************
-* @brief        delete cursor right character
-* @retval int               0:Success -1:Error
+* @brief        feed one byte of bracketed paste, move tail back and
+*               refresh once when \e[201~ is matched.
+*               CR LF and TAB are inserted as space, other controls dropped
+* @retval int               0:Success 1:need more -1:Error
 *****************************************************************************/
-int chry_readline_edit_delete(chry_readline_t *rl)
+static int chry_readline_edit_paste(chry_readline_t *rl, uint8_t *c)
 {
-    if ((rl->ln.curoff < rl->ln.buff->size) && (rl->ln.buff->size > 0)) {
-        memmove(rl->ln.buff->pbuf + rl->ln.curoff,
-                rl->ln.buff->pbuf + rl->ln.curoff + 1,
-                rl->ln.buff->size - rl->ln.curoff - 1);
-        rl->ln.buff->size--;
-        return chry_readline_edit_refresh(rl);
-    }
+    static const char pend[] = "\e[201~";
+    uint8_t byte = *c;
 
-    return 0;
-}
+    *c = CHRY_READLINE_EXEC_NUL;
+    rl->seq.state = CHRY_READLINE_DEC_PASTE;
 
-/*****************************************************************************
-* @brief        move cursor to left
+    if (byte == (uint8_t)pend[rl->paste.match]) {
+        if (++rl->paste.match < sizeof(pend) - 1) {
+            return 1;
+        }
+
+        rl->seq.state = CHRY_READLINE_DEC_IDLE;
+
+        if (rl->paste.drop) {
+            return 0;
+        }
+
+        memmove(rl->ln.buff->pbuf + rl->paste.pos, rl->ln.buff->pbuf + rl->paste.gap, rl->paste.tail);
+        rl->ln.buff->size = rl->paste.pos + rl->paste.tail;
+        rl->ln.curoff = rl->paste.pos;
+
+        return chry_readline_edit_refresh(rl);
+    }
+
+    if (rl->paste.match) {
+        /*!< not end marker, keep held bytes except esc */
+        for (uint8_t i = 1; (i < rl->paste.match) && (rl->paste.pos < rl->paste.gap); i++) {
+            rl->ln.buff->pbuf[rl->paste.pos++] = pend[i];
+        }
+
+        rl->paste.match = (byte == CHRY_READLINE_C0_ESC) ? 1 : 0;
+        if (rl->paste.match) {
+            return 1;
+        }
+    }
+
+    if ((byte == CHRY_READLINE_C0_CR) || (byte == CHRY_READLINE_C0_LF) || (byte == CHRY_READLINE_C0_HT)) {
+        byte = ' ';
+    } else if ((byte < CHRY_READLINE_G0_BEG) || (CHRY_READLINE_G0_END < byte)) {
+        return 1;
+    }
+
+    if (rl->paste.pos < rl->paste.gap) {
+        rl->ln.buff->pbuf[rl->paste.pos++] = byte;
+    }
+
+    return 1;
+}
+#endif
+
+/*****************************************************************************
+* @brief        delete cursor left character
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+int chry_readline_edit_backspace(chry_readline_t *rl)
+{
+    if ((rl->ln.curoff > 0) && (rl->ln.buff->size > 0)) {
+        memmove(rl->ln.buff->pbuf + rl->ln.curoff - 1,
+                rl->ln.buff->pbuf + rl->ln.curoff,
+                rl->ln.buff->size - rl->ln.curoff);
+        rl->ln.buff->size--;
+        rl->ln.curoff--;
+        return chry_readline_edit_refresh(rl);
+    }
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        delete cursor right character
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+int chry_readline_edit_delete(chry_readline_t *rl)
+{
+    if ((rl->ln.curoff < rl->ln.buff->size) && (rl->ln.buff->size > 0)) {
+        memmove(rl->ln.buff->pbuf + rl->ln.curoff,
+                rl->ln.buff->pbuf + rl->ln.curoff + 1,
+                rl->ln.buff->size - rl->ln.curoff - 1);
+        rl->ln.buff->size--;
+        return chry_readline_edit_refresh(rl);
+    }
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        move cursor to left
 * @retval int               0:Success -1:Error
 *****************************************************************************/
 int chry_readline_edit_moveleft(chry_readline_t *rl)
@@ -823,6 +1282,19 @@ static int chry_readline_dispatch_csi(chry_readline_t *rl, uint8_t *c, uint16_t
     uint8_t idx;
 
     if (*c == '~') {
+#if defined(CONFIG_READLINE_PASTE) && CONFIG_READLINE_PASTE
+        if (pns[0] == 200) {
+            /*!< bracketed paste start, text is fed by decoder */
+            *c = CHRY_READLINE_EXEC_NUL;
+            chry_readline_paste_begin(rl);
+            return 0;
+        } else if (pns[0] == 201) {
+            /*!< stray paste end */
+            *c = CHRY_READLINE_EXEC_NUL;
+            return 0;
+        }
+#endif
+
         if (pns[0] >= sizeof(vtmap)) {
             pns[0] = 0;
         }
@@ -945,72 +1417,63 @@ static int chry_readline_dispatch_ctrl(chry_readline_t *rl, uint8_t *c, uint16_t
 }
 
 /*****************************************************************************
-* @brief        parse csi sequences
+* @brief        parse one byte of csi sequences
 *
 * @param[in]    rl          readline instance
-* @param[out]   csiend      final csi seq character
-* @param[out]   expre       extend prefix character
-* @param[out]   pns         array of number param
+* @param[in]    c           input byte
 *
-* @retval int               0:Success -1:Error
+* @retval int               0:final byte 1:need more -1:Error
 *****************************************************************************/
-static int chry_readline_seqexec_pcsi(chry_readline_t *rl, uint8_t *csiend, uint8_t *expre, uint16_t *pns)
+static int chry_readline_seqexec_pcsi(chry_readline_t *rl, uint8_t c)
 {
-    uint8_t csibuf[8];
-    uint8_t *pbuf = csibuf;
-
-    /*!< should have buffered key or it will be blocked */
-    chry_readline_waitkey(rl, pbuf);
-
-    if (('0' <= *pbuf) && (*pbuf <= '9')) {
-        pbuf++;
-    } else if ('?' == *pbuf) {
-        *expre = *pbuf;
-    } else if ((('a' <= *pbuf) && (*pbuf <= 'z')) ||
-               (('A' <= *pbuf) && (*pbuf <= 'Z'))) {
-        *csiend = *pbuf;
+    if (('0' <= c) && (c <= '9')) {
+        if (rl->seq.pnum < sizeof(rl->seq.pns) / sizeof(rl->seq.pns[0])) {
+            rl->seq.pns[rl->seq.pnum] *= 10;
+            rl->seq.pns[rl->seq.pnum] += c - '0';
+        }
+    } else if (c == ';') {
+        if (rl->seq.pnum < sizeof(rl->seq.pns) / sizeof(rl->seq.pns[0])) {
+            rl->seq.pnum++;
+        }
+        if (rl->seq.pnum < sizeof(rl->seq.pns) / sizeof(rl->seq.pns[0])) {
+            rl->seq.pns[rl->seq.pnum] = 0;
+        }
+    } else if (('<' <= c) && (c <= '?')) {
+        /*!< private parameter prefix */
+        rl->seq.expre = c;
+    } else if ((0x40 <= c) && (c <= 0x7e)) {
         return 0;
+    } else if ((c < 0x20) || (0x2f < c)) {
+        /*!< not intermediate byte */
+        return -1;
     }
 
-    for (;;) {
-        /*!< should have buffered key or it will be blocked */
-        chry_readline_waitkey(rl, pbuf);
-
-        if (('0' <= *pbuf) && (*pbuf <= '9')) {
-            pbuf++;
-        } else if (*pbuf == ';') {
-            pbuf = csibuf;
-            chry_readline_parse_integer(csibuf, pns++);
-        } else if ((*pbuf == '~') ||
-                   (('a' <= *pbuf) && (*pbuf <= 'z')) ||
-                   (('A' <= *pbuf) && (*pbuf <= 'Z'))) {
-            *csiend = *pbuf;
-            chry_readline_parse_integer(csibuf, pns++);
-            return 0;
-        } else {
-            return -1;
-        }
-    }
+    return 1;
 }
 
 /*****************************************************************************
 * @brief        execute CSI sequences
 *
 * @param[in]    rl          readline instance
-* @param[out]   c           character for dispatch
+* @param[inout] c           input byte, character for dispatch
 * @param[out]   pns         array of number param
 *
-* @retval int               0:Success -1:Error
+* @retval int               0:Success 1:need more -1:Error
 *****************************************************************************/
 static int chry_readline_seqexec_csi(chry_readline_t *rl, uint8_t *c, uint16_t *pns)
 {
-    uint8_t expre = 0;
+    int ret = chry_readline_seqexec_pcsi(rl, *c);
 
-    if (chry_readline_seqexec_pcsi(rl, c, &expre, pns)) {
-        return -1;
+    if (ret > 0) {
+        rl->seq.state = CHRY_READLINE_DEC_CSI;
+        return 1;
+    } else if (ret < 0) {
+        /*!< malformed, drop sequence */
+        *c = CHRY_READLINE_EXEC_NUL;
+        return 0;
     }
 
-    if (expre) {
+    if (rl->seq.expre) {
         *c = CHRY_READLINE_C0_NUL;
     }
 
@@ -1035,62 +1498,70 @@ static int chry_readline_seqexec_alt(chry_readline_t *rl, uint8_t *c, uint16_t *
 * @brief        execute O sequences
 *
 * @param[in]    rl          readline instance
-* @param[out]   c           character for dispatch
+* @param[inout] c           input byte, character for dispatch
 * @param[out]   pns         array of number param
 *
 * @retval int               0:Success -1:Error
 *****************************************************************************/
 static int chry_readline_seqexec_o(chry_readline_t *rl, uint8_t *c, uint16_t *pns)
 {
-    /*!< should have buffered key or it will be blocked */
-    chry_readline_waitkey(rl, c);
-
     return chry_readline_dispatch_o(rl, c, pns);
 }
 
 /*****************************************************************************
-* @brief        execute sequences
+* @brief        feed one byte to sequence decoder, state is kept in rl
+*               so a sequence split across sget calls resumes on next call
 *
 * @param[in]    rl          readline instance
-* @param[inout] c           character for dispatch
-* @param[out]   pns         array of number param
+* @param[inout] c           input byte, character for dispatch
 *
-* @retval int               0:Success -1:Error
+* @retval int               0:Success 1:need more -1:Error
 *****************************************************************************/
-static int chry_readline_seqexec(chry_readline_t *rl, uint8_t *c, uint16_t *pns)
+static int chry_readline_seqexec(chry_readline_t *rl, uint8_t *c)
 {
-    /*!< should have buffered key or it will be blocked */
-    chry_readline_waitkey(rl, c);
+    uint8_t state = rl->seq.state;
+
+    /*!< sequence complete unless handler keeps a state */
+    rl->seq.state = CHRY_READLINE_DEC_IDLE;
+
+    switch (state) {
+        case CHRY_READLINE_DEC_ESC:
+            if (*c == '[') {
+                rl->seq.state = CHRY_READLINE_DEC_CSI;
+                rl->seq.expre = 0;
+                rl->seq.pnum = 0;
+                rl->seq.pns[0] = 0;
+                return 1;
+            } else if (*c == 'O') {
+                rl->seq.state = CHRY_READLINE_DEC_SS3;
+                return 1;
+            }
+            return chry_readline_seqexec_alt(rl, c, rl->seq.pns);
+
+        case CHRY_READLINE_DEC_CSI:
+            return chry_readline_seqexec_csi(rl, c, rl->seq.pns);
+
+        case CHRY_READLINE_DEC_SS3:
+            return chry_readline_seqexec_o(rl, c, rl->seq.pns);
+
+#if defined(CONFIG_READLINE_PASTE) && CONFIG_READLINE_PASTE
+        case CHRY_READLINE_DEC_PASTE:
+            return chry_readline_edit_paste(rl, c);
+#endif
 
-    switch (*c) {
-        case 'O':
-            return chry_readline_seqexec_o(rl, c, pns);
-        case '[':
-            return chry_readline_seqexec_csi(rl, c, pns);
         default:
-            return chry_readline_seqexec_alt(rl, c, pns);
+            *c = CHRY_READLINE_EXEC_NUL;
+            return 0;
     }
 }
 
 #if defined(CONFIG_READLINE_HISTORY) && CONFIG_READLINE_HISTORY
 
-/*****************************************************************************
-* @brief        reverse memcpy 2byte align
-*
-* @param[in]    dst
-* @param[in]    src
-* @param[in]    n           byte
-*
-*****************************************************************************/
-static void chry_readline_rvsememcpy2(void *dst, const void *src, size_t n)
-{
-    uint16_t *pout = dst;
-    uint16_t *pin = (uint16_t *)src - 1;
-
-    for (; n > 0; n -= 2) {
-        *pout++ = *pin--;
-    }
-}
+#if defined(CONFIG_READLINE_HISTORY_PACK) && CONFIG_READLINE_HISTORY_PACK
+#define CHRY_READLINE_HIST_HEADER 3 /*!< line size and shared prefix size */
+#else
+#define CHRY_READLINE_HIST_HEADER 2 /*!< line size */
+#endif
 
 /*****************************************************************************
 * @brief        align 2 up
@@ -1109,173 +1580,999 @@ static uint32_t chry_readline_align2(uint32_t size)
 }
 
 /*****************************************************************************
-* @brief        cache linbuff to history list
+* @brief        get ring position of history entry
 *
 * @param[in]    rl          readline instance
+* @param[in]    index       history index, 0 is the line cached before browsing
+* @param[out]   start       entry start pos
 *
+* @retval                   entry end pos
 *****************************************************************************/
-static void chry_readline_history_cache(chry_readline_t *rl)
+static uint16_t chry_readline_history_span(chry_readline_t *rl, uint16_t index, uint16_t *start)
 {
-    uint16_t unused;
-    uint16_t offset;
-    uint16_t remain;
-    uint16_t lnsize;
-    uint8_t *dst;
-
-    /*!< fifo unused size */
-    unused = rl->hist.size - (rl->hist.cache - rl->hist.out);
+    if (index == 0) {
+        *start = rl->hist.cache;
+        return rl->hist.in;
+    }
 
-    /*!< line and size total size, alignup 2 */
-    lnsize = chry_readline_align2(rl->ln.buff->size + 2);
+    /*!< entry ends where the newer one starts */
+    *start = rl->hist.ipos[(rl->hist.iin - index) & (CONFIG_READLINE_HISTORY_DEPTH - 1)];
 
-    /*!< free the oldest history */
-    if (lnsize > unused) {
-        rl->hist.out += lnsize - unused;
+    if (index == 1) {
+        return rl->hist.cache;
     }
 
-    /*!< fifo write offset */
-    offset = rl->hist.cache & rl->hist.mask;
+    return rl->hist.ipos[(rl->hist.iin - index + 1) & (CONFIG_READLINE_HISTORY_DEPTH - 1)];
+}
 
-    /*!< unused size before ringloop */
-    remain = rl->hist.size - offset;
-    remain = remain > lnsize ? lnsize : remain;
+/*****************************************************************************
+* @brief        get line size of history entry
+*
+* @param[in]    rl          readline instance
+* @param[in]    start       entry start pos
+*
+* @retval                   line size
+*****************************************************************************/
+static uint16_t chry_readline_history_lnsize(chry_readline_t *rl, uint16_t start)
+{
+    uint16_t lnsize;
 
-    dst = (uint8_t *)(rl->ln.buff) + lnsize;
+    /*!< size header is 2byte aligned, never split by ringloop */
+    memcpy(&lnsize, rl->hist.pbuf + (start & rl->hist.mask), 2);
 
-    chry_readline_rvsememcpy2(rl->hist.pbuf + offset, dst, remain);
-    chry_readline_rvsememcpy2(rl->hist.pbuf, dst - remain, lnsize - remain);
+    return lnsize;
+}
 
-    rl->hist.in = rl->hist.cache + lnsize;
+/*****************************************************************************
+* @brief        get prefix size shared with the older entry
+*
+* @param[in]    rl          readline instance
+* @param[in]    start       entry start pos
+*
+* @retval                   shared size, 0:full line stored
+*****************************************************************************/
+static uint16_t chry_readline_history_shared(chry_readline_t *rl, uint16_t start)
+{
+    (void)rl;
+    (void)start;
+#if defined(CONFIG_READLINE_HISTORY_PACK) && CONFIG_READLINE_HISTORY_PACK
+    return (uint8_t)rl->hist.pbuf[(start + 2) & rl->hist.mask];
+#else
+    return 0;
+#endif
 }
 
 /*****************************************************************************
-* @brief        store linebuff to history list
+* @brief        get line character of history entry, shared prefix is read
+*               from older entries
 *
 * @param[in]    rl          readline instance
+* @param[in]    index       history index
+* @param[in]    offset      line offset
 *
+* @retval                   character
 *****************************************************************************/
-static void chry_readline_history_store(chry_readline_t *rl)
+static char chry_readline_history_lnchar(chry_readline_t *rl, uint16_t index, uint16_t offset)
 {
-    if (rl->ln.buff->size > 0) {
-        chry_readline_history_cache(rl);
+    uint16_t start;
+    uint16_t shared;
 
-        /*!< update cache index */
-        rl->hist.cache = rl->hist.in;
+    chry_readline_history_span(rl, index, &start);
+
+    while (offset < (shared = chry_readline_history_shared(rl, start))) {
+        chry_readline_history_span(rl, ++index, &start);
     }
+
+    return rl->hist.pbuf[(start + CHRY_READLINE_HIST_HEADER + offset - shared) & rl->hist.mask];
 }
 
 /*****************************************************************************
-* @brief        load special index history to linebuff
+* @brief        get record size in history ring
+*
+* @param[in]    lnsize      line size
+* @param[in]    shared      prefix size shared with the older entry
+*
+* @retval                   record size, alignup 2
+*****************************************************************************/
+static uint16_t chry_readline_history_recsize(uint16_t lnsize, uint16_t shared)
+{
+    return chry_readline_align2(CHRY_READLINE_HIST_HEADER + lnsize - shared);
+}
+
+/*****************************************************************************
+* @brief        write linebuff record to history ring, record is size header
+*               and the line after shared prefix in forward order
 *
 * @param[in]    rl          readline instance
-* @param[in]    index       history index
+* @param[in]    pos         record start pos
+* @param[in]    shared      prefix size shared with the older entry
 *
-* @retval                   0:Success -1:Error
 *****************************************************************************/
-static int chry_readline_history_load(chry_readline_t *rl, uint16_t index)
+static void chry_readline_history_write(chry_readline_t *rl, uint16_t pos, uint16_t shared)
 {
-    uint16_t used;
     uint16_t offset;
     uint16_t remain;
     uint16_t lnsize;
-    uint16_t histin;
-    uint16_t count;
-    uint16_t prevused;
 
-    if (rl->hist.index == 0) {
-        chry_readline_history_cache(rl);
-    }
+    memcpy(rl->hist.pbuf + (pos & rl->hist.mask), &rl->ln.buff->size, 2);
+#if defined(CONFIG_READLINE_HISTORY_PACK) && CONFIG_READLINE_HISTORY_PACK
+    rl->hist.pbuf[(pos + 2) & rl->hist.mask] = shared;
+#endif
 
-    lnsize = 0;
-    count = index;
-    histin = rl->hist.in;
-    prevused = rl->hist.in - rl->hist.out;
+    /*!< fifo write offset */
+    offset = (pos + CHRY_READLINE_HIST_HEADER) & rl->hist.mask;
+    lnsize = rl->ln.buff->size - shared;
 
-    do {
-        histin -= lnsize;
+    /*!< unused size before ringloop */
+    remain = rl->hist.size - offset;
+    remain = remain > lnsize ? lnsize : remain;
 
-        /*!< fifo used size */
-        used = histin - rl->hist.out;
+    memcpy(rl->hist.pbuf + offset, rl->ln.buff->pbuf + shared, remain);
+    memcpy(rl->hist.pbuf, rl->ln.buff->pbuf + shared + remain, lnsize - remain);
+}
 
-        if ((used == 0) || (used > prevused)) {
-            return 0;
+#if defined(CONFIG_READLINE_HISTORY_PACK) && CONFIG_READLINE_HISTORY_PACK
+/*****************************************************************************
+* @brief        move bytes inside history ring, regions may overlap
+*
+* @param[in]    rl          readline instance
+* @param[in]    dst         dst pos
+* @param[in]    src         src pos
+* @param[in]    n           byte
+*
+*****************************************************************************/
+static void chry_readline_history_move(chry_readline_t *rl, uint16_t dst, uint16_t src, uint16_t n)
+{
+    if ((int16_t)(dst - src) > 0) {
+        while (n--) {
+            rl->hist.pbuf[(dst + n) & rl->hist.mask] = rl->hist.pbuf[(src + n) & rl->hist.mask];
         }
-
-        prevused = used;
-
-        /*!< fifo read offset */
-        offset = (histin - 2) & rl->hist.mask;
-
-        /*!< read fisrt 2byte and alignup 2 */
-        lnsize = chry_readline_align2(((uint32_t *)(rl->hist.pbuf + offset))[0] + 2);
-
-        if (lnsize > used) {
-            return 0;
+    } else {
+        for (uint16_t i = 0; i < n; i++) {
+            rl->hist.pbuf[(dst + i) & rl->hist.mask] = rl->hist.pbuf[(src + i) & rl->hist.mask];
         }
+    }
+}
 
-    } while (count--);
+/*****************************************************************************
+* @brief        rewrite history entry to share no more prefix than the older
+*               entry does, so the older one can be dropped or erased. bytes
+*               taken from the older entry always fit in its record
+*
+* @param[in]    rl          readline instance
+* @param[in]    index       history index, the older entry must exist
+*
+*****************************************************************************/
+static void chry_readline_history_rebase(chry_readline_t *rl, uint16_t index)
+{
+    uint16_t ostart;
+    uint16_t start;
+    uint16_t end;
+    uint16_t lnsize;
+    uint16_t shared;
+    uint16_t oshared;
+    uint16_t pos;
 
-    offset = (histin - lnsize) & rl->hist.mask;
+    chry_readline_history_span(rl, index + 1, &ostart);
+    end = chry_readline_history_span(rl, index, &start);
 
-    /*!< unused size before ringloop */
-    remain = rl->hist.size - offset;
-    remain = remain > lnsize ? lnsize : remain;
+    shared = chry_readline_history_shared(rl, start);
+    oshared = chry_readline_history_shared(rl, ostart);
 
-    /*!< temp value */
-    lnsize = lnsize - remain;
+    if (shared <= oshared) {
+        return;
+    }
 
-    chry_readline_rvsememcpy2((uint8_t *)(rl->ln.buff) + lnsize,
-                              rl->hist.pbuf + offset + remain, remain);
+    lnsize = chry_readline_history_lnsize(rl, start);
+    pos = end - chry_readline_history_recsize(lnsize, oshared);
 
-    chry_readline_rvsememcpy2(rl->ln.buff, rl->hist.pbuf + lnsize, lnsize);
+    /*!< own suffix first, then the part of older suffix below it */
+    chry_readline_history_move(rl, pos + CHRY_READLINE_HIST_HEADER + shared - oshared,
+                               start + CHRY_READLINE_HIST_HEADER, lnsize - shared);
+    chry_readline_history_move(rl, pos + CHRY_READLINE_HIST_HEADER,
+                               ostart + CHRY_READLINE_HIST_HEADER, shared - oshared);
 
-    rl->ln.curoff = rl->ln.buff->size;
-    rl->hist.index = index;
-    return chry_readline_edit_refresh(rl);
+    memcpy(rl->hist.pbuf + (pos & rl->hist.mask), &lnsize, 2);
+    rl->hist.pbuf[(pos + 2) & rl->hist.mask] = oshared;
+
+    rl->hist.ipos[(rl->hist.iin - index) & (CONFIG_READLINE_HISTORY_DEPTH - 1)] = pos;
 }
+#endif
 
 /*****************************************************************************
-* @brief        load prev history to linebuff
+* @brief        drop the oldest history entry from index
 *
 * @param[in]    rl          readline instance
 *
-* @retval                   0:Success -1:Error
 *****************************************************************************/
-static int chry_readline_history_loadprev(chry_readline_t *rl)
+static void chry_readline_history_drop(chry_readline_t *rl)
 {
-    uint16_t lnhist = rl->hist.index + 1;
+#if defined(CONFIG_READLINE_HISTORY_PACK) && CONFIG_READLINE_HISTORY_PACK
+    uint16_t count = rl->hist.iin - rl->hist.iout;
 
-    return chry_readline_history_load(rl, lnhist);
+    /*!< the oldest entry always stores full line */
+    if (count > 1) {
+        chry_readline_history_rebase(rl, count - 1);
+    }
+#endif
+
+    rl->hist.iout++;
 }
 
 /*****************************************************************************
-* @brief        load next history to linebuff
+* @brief        cache linbuff to history list
 *
 * @param[in]    rl          readline instance
 *
-* @retval                   0:Success -1:Error
 *****************************************************************************/
-static int chry_readline_history_loadnext(chry_readline_t *rl)
+static void chry_readline_history_cache(chry_readline_t *rl)
 {
-    uint16_t lnhist = rl->hist.index > 0 ? rl->hist.index - 1 : 0;
+    uint16_t unused;
+    uint16_t lnsize;
+    uint16_t shared = 0;
 
-    return chry_readline_history_load(rl, lnhist);
-}
+#if defined(CONFIG_READLINE_HISTORY_PACK) && CONFIG_READLINE_HISTORY_PACK
+    if (rl->hist.iin != rl->hist.iout) {
+        uint16_t start;
+        uint16_t max;
+
+        /*!< prefix shared with the newest entry */
+        chry_readline_history_span(rl, 1, &start);
+        max = chry_readline_history_lnsize(rl, start);
+        max = max > rl->ln.buff->size ? rl->ln.buff->size : max;
+        max = max > 0xff ? 0xff : max;
+
+        while ((shared < max) && (chry_readline_history_lnchar(rl, 1, shared) == rl->ln.buff->pbuf[shared])) {
+            shared++;
+        }
+    }
+#endif
+
+    /*!< fifo unused size */
+    unused = rl->hist.size - (rl->hist.cache - rl->hist.out);
+
+    /*!< record total size, alignup 2 */
+    lnsize = chry_readline_history_recsize(rl->ln.buff->size, shared);
+
+    /*!< free the oldest history */
+    if (lnsize > unused) {
+        rl->hist.out += lnsize - unused;
+
+        /*!< drop index of entries overwritten */
+        while ((rl->hist.iin != rl->hist.iout) &&
+               ((int16_t)(rl->hist.ipos[rl->hist.iout & (CONFIG_READLINE_HISTORY_DEPTH - 1)] - rl->hist.out) < 0)) {
+            chry_readline_history_drop(rl);
+        }
 
+#if defined(CONFIG_READLINE_HISTORY_PACK) && CONFIG_READLINE_HISTORY_PACK
+        if ((rl->hist.iin == rl->hist.iout) && shared) {
+            /*!< newest entry dropped too, store full line */
+            shared = 0;
+            unused = rl->hist.size - (rl->hist.cache - rl->hist.out);
+            lnsize = chry_readline_history_recsize(rl->ln.buff->size, 0);
+            if (lnsize > unused) {
+                rl->hist.out += lnsize - unused;
+            }
+        }
 #endif
+    }
+
+    chry_readline_history_write(rl, rl->hist.cache, shared);
+
+    rl->hist.in = rl->hist.cache + lnsize;
+}
 
+#if defined(CONFIG_READLINE_HISTORY_DEDUP) && CONFIG_READLINE_HISTORY_DEDUP
 /*****************************************************************************
-* @brief        auto completion
+* @brief        hash linebuff for duplicate check
 *
 * @param[in]    rl          readline instance
 *
-* @retval int               0:Success -1:Error 1:Restart
+* @retval                   hash value
 *****************************************************************************/
-int chry_readline_complete(chry_readline_t *rl)
+static uint16_t chry_readline_history_hash(chry_readline_t *rl)
 {
-#if defined(CONFIG_READLINE_COMPLETION) && CONFIG_READLINE_COMPLETION
-    uint8_t count;
-    char *pre;
+    uint16_t hash = 0x811c;
+
+    for (uint16_t i = 0; i < rl->ln.buff->size; i++) {
+        hash = (hash ^ (uint8_t)rl->ln.buff->pbuf[i]) * 0x0193;
+    }
+
+    return hash;
+}
+
+/*****************************************************************************
+* @brief        find history entry equal to linebuff, length and hash are
+*               checked first, the ring is read only when both match
+*
+* @param[in]    rl          readline instance
+* @param[in]    hash        linebuff hash
+* @param[in]    index       history index to start, newer entries skipped
+* @param[in]    depth       history index to stop, inclusive
+*
+* @retval                   history index, 0:not found
+*****************************************************************************/
+static uint16_t chry_readline_history_find(chry_readline_t *rl, uint16_t hash, uint16_t index, uint16_t depth)
+{
+    uint16_t start;
+    uint16_t i;
+
+    for (; index <= depth; index++) {
+        chry_readline_history_span(rl, index, &start);
+
+        if ((chry_readline_history_lnsize(rl, start) != rl->ln.buff->size) ||
+            (rl->hist.ihash[(rl->hist.iin - index) & (CONFIG_READLINE_HISTORY_DEPTH - 1)] != hash)) {
+            continue;
+        }
+
+        for (i = 0; i < rl->ln.buff->size; i++) {
+            if (chry_readline_history_lnchar(rl, index, i) != rl->ln.buff->pbuf[i]) {
+                break;
+            }
+        }
+
+        if (i == rl->ln.buff->size) {
+            return index;
+        }
+    }
+
+    return 0;
+}
+
+#if CONFIG_READLINE_HISTORY_DEDUP > 1
+/*****************************************************************************
+* @brief        erase history entry, newer entries are moved down over it
+*
+* @param[in]    rl          readline instance
+* @param[in]    index       history index, not less than 2
+*
+*****************************************************************************/
+static void chry_readline_history_erase(chry_readline_t *rl, uint16_t index)
+{
+    uint16_t lnsize;
+    uint16_t start;
+    uint16_t end;
+    uint16_t slot;
+    uint16_t next;
+
+#if defined(CONFIG_READLINE_HISTORY_PACK) && CONFIG_READLINE_HISTORY_PACK
+    /*!< newer entry must not share more than this entry's older one */
+    chry_readline_history_rebase(rl, index - 1);
+#endif
+
+    end = chry_readline_history_span(rl, index, &start);
+    lnsize = end - start;
+
+    for (; end != rl->hist.cache; end++) {
+        rl->hist.pbuf[(end - lnsize) & rl->hist.mask] = rl->hist.pbuf[end & rl->hist.mask];
+    }
+
+    /*!< close the gap in index */
+    for (; index > 1; index--) {
+        slot = (rl->hist.iin - index) & (CONFIG_READLINE_HISTORY_DEPTH - 1);
+        next = (rl->hist.iin - index + 1) & (CONFIG_READLINE_HISTORY_DEPTH - 1);
+        rl->hist.ipos[slot] = rl->hist.ipos[next] - lnsize;
+        rl->hist.ihash[slot] = rl->hist.ihash[next];
+    }
+
+    rl->hist.iin--;
+    rl->hist.cache -= lnsize;
+}
+#endif
+#endif
+
+/*****************************************************************************
+* @brief        store linebuff to history list
+*
+* @param[in]    rl          readline instance
+*
+*****************************************************************************/
+static void chry_readline_history_store(chry_readline_t *rl)
+{
+    if (rl->ln.buff->size > 0) {
+#if defined(CONFIG_READLINE_HISTORY_DEDUP) && CONFIG_READLINE_HISTORY_DEDUP
+        uint16_t hash = chry_readline_history_hash(rl);
+        uint16_t count = rl->hist.iin - rl->hist.iout;
+        uint16_t index;
+
+#if CONFIG_READLINE_HISTORY_DEDUP > 1
+        index = chry_readline_history_find(rl, hash, 1, count);
+        if (index > 1) {
+            /*!< keep only the newest copy */
+            chry_readline_history_erase(rl, index);
+        }
+#else
+        index = chry_readline_history_find(rl, hash, 1, count ? 1 : 0);
+#endif
+
+        if (index == 1) {
+            /*!< same as the last entry */
+            return;
+        }
+#endif
+
+        chry_readline_history_cache(rl);
+
+        /*!< index full, oldest entry is no longer reachable */
+        if ((uint16_t)(rl->hist.iin - rl->hist.iout) == CONFIG_READLINE_HISTORY_DEPTH) {
+            chry_readline_history_drop(rl);
+        }
+
+        /*!< index entry start */
+        rl->hist.ipos[rl->hist.iin & (CONFIG_READLINE_HISTORY_DEPTH - 1)] = rl->hist.cache;
+#if defined(CONFIG_READLINE_HISTORY_DEDUP) && CONFIG_READLINE_HISTORY_DEDUP
+        rl->hist.ihash[rl->hist.iin & (CONFIG_READLINE_HISTORY_DEPTH - 1)] = hash;
+#endif
+        rl->hist.iin++;
+
+        /*!< update cache index */
+        rl->hist.cache = rl->hist.in;
+
+#if defined(CONFIG_READLINE_HISTORY_STORE) && CONFIG_READLINE_HISTORY_STORE
+        if (rl->hist.hsave) {
+            rl->hist.hsave(rl, rl->ln.buff->pbuf, rl->ln.buff->size);
+            rl->hist.saved++;
+        }
+#endif
+    }
+}
+
+/*****************************************************************************
+* @brief        copy special index history to linebuff without refresh
+*
+* @param[in]    rl          readline instance
+* @param[in]    index       history index
+*
+* @retval                   1:Copied 0:No entry
+*****************************************************************************/
+static int chry_readline_history_fetch(chry_readline_t *rl, uint16_t index)
+{
+    uint16_t offset;
+    uint16_t remain;
+    uint16_t shared;
+    uint16_t lnsize;
+    uint16_t start;
+    uint16_t end;
+
+    if (index > (uint16_t)(rl->hist.iin - rl->hist.iout)) {
+        return 0;
+    }
+
+    end = chry_readline_history_span(rl, index, &start);
+
+    /*!< cached line evicted by a long current line */
+    if ((end == start) || ((int16_t)(start - rl->hist.out) < 0)) {
+        return 0;
+    }
+
+    lnsize = chry_readline_history_lnsize(rl, start);
+    rl->ln.buff->size = lnsize;
+
+    /*!< copy own suffix, then walk older entries for the shared prefix */
+    for (uint16_t older = index;; chry_readline_history_span(rl, ++older, &start)) {
+        shared = chry_readline_history_shared(rl, start);
+
+        if (shared < lnsize) {
+            offset = (start + CHRY_READLINE_HIST_HEADER) & rl->hist.mask;
+
+            /*!< unused size before ringloop */
+            remain = rl->hist.size - offset;
+            remain = remain > (lnsize - shared) ? (lnsize - shared) : remain;
+
+            memcpy(rl->ln.buff->pbuf + shared, rl->hist.pbuf + offset, remain);
+            memcpy(rl->ln.buff->pbuf + shared + remain, rl->hist.pbuf, lnsize - shared - remain);
+
+            lnsize = shared;
+        }
+
+        if (lnsize == 0) {
+            break;
+        }
+    }
+
+    rl->ln.curoff = rl->ln.buff->size;
+    rl->hist.index = index;
+    return 1;
+}
+
+/*****************************************************************************
+* @brief        load special index history to linebuff
+*
+* @param[in]    rl          readline instance
+* @param[in]    index       history index
+*
+* @retval                   0:Success -1:Error
+*****************************************************************************/
+static int chry_readline_history_load(chry_readline_t *rl, uint16_t index)
+{
+    if (rl->hist.index == 0) {
+        chry_readline_history_cache(rl);
+    }
+
+    if (!chry_readline_history_fetch(rl, index)) {
+        return 0;
+    }
+
+    return chry_readline_edit_refresh(rl);
+}
+
+#if defined(CONFIG_READLINE_HISTORY_STORE) && CONFIG_READLINE_HISTORY_STORE
+/*****************************************************************************
+* @brief        load stored history older than this boot into the ring, below
+*               the oldest entry, until ring or index is full. linebuff is
+*               used as read buffer and restored from history cache
+*
+* @param[in]    rl          readline instance
+*
+*****************************************************************************/
+static void chry_readline_history_restore(chry_readline_t *rl)
+{
+    uint32_t cursor = 0;
+    uint16_t curoff = rl->ln.curoff;
+    uint16_t skip = rl->hist.saved;
+    uint16_t lnsize;
+    uint16_t start;
+    int size;
+
+    rl->hist.lazy = 0;
+
+    if (rl->hist.index == 0) {
+        chry_readline_history_cache(rl);
+    }
+
+    while ((uint16_t)(rl->hist.iin - rl->hist.iout) < CONFIG_READLINE_HISTORY_DEPTH) {
+        size = rl->hist.hread(rl, &cursor, rl->ln.buff->pbuf, rl->ln.lnmax);
+        if (size < 0) {
+            break;
+        }
+
+        /*!< newest records are saved this boot, already in ring */
+        if (skip) {
+            skip--;
+            continue;
+        }
+
+        if (size == 0) {
+            continue;
+        }
+
+        rl->ln.buff->size = size;
+
+#if defined(CONFIG_READLINE_HISTORY_DEDUP) && CONFIG_READLINE_HISTORY_DEDUP
+        uint16_t hash = chry_readline_history_hash(rl);
+
+        uint16_t count = rl->hist.iin - rl->hist.iout;
+
+#if CONFIG_READLINE_HISTORY_DEDUP > 1
+        if (chry_readline_history_find(rl, hash, 1, count)) {
+            /*!< a newer copy is kept */
+            continue;
+        }
+#else
+        if (chry_readline_history_find(rl, hash, count ? count : 1, count)) {
+            /*!< same as the oldest entry */
+            continue;
+        }
+#endif
+#endif
+
+        lnsize = chry_readline_history_recsize(size, 0);
+        start = (rl->hist.iin == rl->hist.iout) ? rl->hist.cache : rl->hist.ipos[rl->hist.iout & (CONFIG_READLINE_HISTORY_DEPTH - 1)];
+        start -= lnsize;
+
+        /*!< no space left below the oldest entry */
+        if ((uint16_t)(rl->hist.in - start) > rl->hist.size) {
+            break;
+        }
+
+        chry_readline_history_write(rl, start, 0);
+
+        rl->hist.iout--;
+        rl->hist.ipos[rl->hist.iout & (CONFIG_READLINE_HISTORY_DEPTH - 1)] = start;
+#if defined(CONFIG_READLINE_HISTORY_DEDUP) && CONFIG_READLINE_HISTORY_DEDUP
+        rl->hist.ihash[rl->hist.iout & (CONFIG_READLINE_HISTORY_DEPTH - 1)] = hash;
+#endif
+
+        if ((int16_t)(start - rl->hist.out) < 0) {
+            rl->hist.out = start;
+        }
+    }
+
+    /*!< restore linebuff */
+    chry_readline_history_fetch(rl, 0);
+    rl->ln.curoff = curoff;
+}
+#endif
+
+#if defined(CONFIG_READLINE_HISTORY_PREFIX) && CONFIG_READLINE_HISTORY_PREFIX
+/*****************************************************************************
+* @brief        check history entry starts with linebuff prefix, compared in
+*               the ring without loading the entry
+*
+* @param[in]    rl          readline instance
+* @param[in]    index       history index
+*
+* @retval                   1:Match 0:Not match
+*****************************************************************************/
+static int chry_readline_history_prefix(chry_readline_t *rl, uint16_t index)
+{
+    uint16_t prefix;
+    uint16_t start;
+
+    /*!< linebuff may be edited shorter while browsing */
+    prefix = rl->hist.plen > rl->ln.buff->size ? rl->ln.buff->size : rl->hist.plen;
+
+    chry_readline_history_span(rl, index, &start);
+
+    if (chry_readline_history_lnsize(rl, start) < prefix) {
+        return 0;
+    }
+
+    for (uint16_t i = 0; i < prefix; i++) {
+        if (chry_readline_history_lnchar(rl, index, i) != rl->ln.buff->pbuf[i]) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+#endif
+
+#if defined(CONFIG_READLINE_HISTORY_EXPAND) && CONFIG_READLINE_HISTORY_EXPAND
+/*****************************************************************************
+* @brief        expand history event at line start, !! last, !-n n-th last,
+*               !prefix last starting with prefix. absolute event numbers
+*               are not supported, !n is taken as a prefix. the rest of
+*               line is kept after the expanded entry
+*
+* @param[in]    rl          readline instance
+*
+* @retval int               0:Success -1:Error 1:Event not found
+*****************************************************************************/
+static int chry_readline_history_expand(chry_readline_t *rl)
+{
+    static const char notfound[] = ": event not found";
+    char *line = rl->ln.buff->pbuf;
+    uint16_t size = rl->ln.buff->size;
+    uint16_t count;
+    uint16_t index = 0;
+    uint16_t event = 0;
+    uint16_t start;
+    uint16_t lnsize;
+    uint16_t dlen;
+    uint16_t i;
+
+    if ((size < 2) || (line[0] != '!') || (line[1] == ' ')) {
+        return 0;
+    }
+
+#if defined(CONFIG_READLINE_HISTORY_STORE) && CONFIG_READLINE_HISTORY_STORE
+    if (rl->hist.lazy) {
+        chry_readline_history_restore(rl);
+    }
+#endif
+
+    count = rl->hist.iin - rl->hist.iout;
+
+    if (line[1] == '!') {
+        dlen = 2;
+        index = 1;
+    } else if (line[1] == '-') {
+        for (dlen = 2; (dlen < size) && ('0' <= line[dlen]) && (line[dlen] <= '9'); dlen++) {
+            event = event * 10 + (line[dlen] - '0');
+        }
+
+        index = event;
+    } else {
+        for (dlen = 1; (dlen < size) && (line[dlen] != ' '); dlen++) {
+        }
+
+        for (index = 1; index <= count; index++) {
+            chry_readline_history_span(rl, index, &start);
+            if (chry_readline_history_lnsize(rl, start) < (dlen - 1)) {
+                continue;
+            }
+
+            for (i = 1; (i < dlen) && (chry_readline_history_lnchar(rl, index, i - 1) == line[i]); i++) {
+            }
+
+            if (i == dlen) {
+                break;
+            }
+        }
+    }
+
+    if ((index != 0) && (index <= count)) {
+        chry_readline_history_span(rl, index, &start);
+        lnsize = chry_readline_history_lnsize(rl, start);
+
+        if ((lnsize + size - dlen) <= rl->ln.lnmax) {
+            /*!< keep the rest after entry, then fill entry in front */
+            memmove(line + lnsize, line + dlen, size - dlen);
+            chry_readline_history_fetch(rl, index);
+            rl->ln.buff->size = lnsize + size - dlen;
+            rl->ln.curoff = rl->ln.buff->size;
+
+            /*!< show the line executed */
+            return chry_readline_edit_refresh(rl);
+        }
+    }
+
+    chry_readline_put(rl, CONFIG_READLINE_NEWLINE, sizeof(CONFIG_READLINE_NEWLINE) ? sizeof(CONFIG_READLINE_NEWLINE) - 1 : 0, -1);
+    chry_readline_put(rl, line, dlen, -1);
+    chry_readline_put(rl, notfound, sizeof(notfound) - 1, -1);
+
+    return 1;
+}
+#endif
+
+/*****************************************************************************
+* @brief        load prev history to linebuff
+*
+* @param[in]    rl          readline instance
+*
+* @retval                   0:Success -1:Error
+*****************************************************************************/
+static int chry_readline_history_loadprev(chry_readline_t *rl)
+{
+    uint16_t lnhist = rl->hist.index + 1;
+
+#if defined(CONFIG_READLINE_HISTORY_STORE) && CONFIG_READLINE_HISTORY_STORE
+    if (rl->hist.lazy) {
+        chry_readline_history_restore(rl);
+    }
+#endif
+
+#if defined(CONFIG_READLINE_HISTORY_PREFIX) && CONFIG_READLINE_HISTORY_PREFIX
+    if (rl->hist.index == 0) {
+        /*!< text before cursor is the prefix while browsing */
+        rl->hist.plen = rl->ln.curoff;
+    }
+
+    while ((lnhist <= (uint16_t)(rl->hist.iin - rl->hist.iout)) && !chry_readline_history_prefix(rl, lnhist)) {
+        lnhist++;
+    }
+#endif
+
+    return chry_readline_history_load(rl, lnhist);
+}
+
+/*****************************************************************************
+* @brief        load next history to linebuff
+*
+* @param[in]    rl          readline instance
+*
+* @retval                   0:Success -1:Error
+*****************************************************************************/
+static int chry_readline_history_loadnext(chry_readline_t *rl)
+{
+    uint16_t lnhist = rl->hist.index > 0 ? rl->hist.index - 1 : 0;
+
+#if defined(CONFIG_READLINE_HISTORY_PREFIX) && CONFIG_READLINE_HISTORY_PREFIX
+    /*!< index 0 is the line before browsing, always visited */
+    while ((lnhist > 0) && !chry_readline_history_prefix(rl, lnhist)) {
+        lnhist--;
+    }
+#endif
+
+    return chry_readline_history_load(rl, lnhist);
+}
+
+#if defined(CONFIG_READLINE_HISTORY_SEARCH) && CONFIG_READLINE_HISTORY_SEARCH
+/*****************************************************************************
+* @brief        check history entry contains search pattern
+*
+* @param[in]    rl          readline instance
+* @param[in]    index       history index
+*
+* @retval                   1:Match 0:Not match
+*****************************************************************************/
+static int chry_readline_search_match(chry_readline_t *rl, uint16_t index)
+{
+    uint16_t lnsize;
+    uint16_t start;
+    uint16_t i;
+    uint16_t j;
+
+    chry_readline_history_span(rl, index, &start);
+    lnsize = chry_readline_history_lnsize(rl, start);
+
+    for (i = 0; (i + rl->srch.size) <= lnsize; i++) {
+        for (j = 0; j < rl->srch.size; j++) {
+            if (chry_readline_history_lnchar(rl, index, i + j) != rl->srch.pattern[j]) {
+                break;
+            }
+        }
+
+        if (j == rl->srch.size) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        search older history from index, load the first match
+*
+* @param[in]    rl          readline instance
+* @param[in]    index       history index to start, inclusive
+*
+*****************************************************************************/
+static void chry_readline_search_next(chry_readline_t *rl, uint16_t index)
+{
+    uint16_t count = rl->hist.iin - rl->hist.iout;
+
+    for (; index <= count; index++) {
+        if (chry_readline_search_match(rl, index)) {
+            chry_readline_history_fetch(rl, index);
+            rl->srch.fail = 0;
+            return;
+        }
+    }
+
+    /*!< keep the last match */
+    rl->srch.fail = 1;
+}
+
+/*****************************************************************************
+* @brief        refresh search line
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int chry_readline_search_refresh(chry_readline_t *rl)
+{
+    static const char label[] = "(reverse-i-search)`";
+    static const char failed[] = "(failed reverse-i-search)`";
+    uint16_t used;
+    uint16_t linesize;
+
+    /*!< move to line start */
+    chry_readline_put(rl, CHRY_READLINE_SEQ_CHA0, sizeof(CHRY_READLINE_SEQ_CHA0) - 1, -1);
+
+    if (rl->srch.fail) {
+        chry_readline_put(rl, failed, sizeof(failed) - 1, -1);
+        used = sizeof(failed) - 1;
+    } else {
+        chry_readline_put(rl, label, sizeof(label) - 1, -1);
+        used = sizeof(label) - 1;
+    }
+
+    chry_readline_put(rl, rl->srch.pattern, rl->srch.size, -1);
+    chry_readline_put(rl, "': ", 3, -1);
+    used += rl->srch.size + 3;
+
+    /*!< show only the matching entry, cut at terminal width */
+    linesize = rl->ln.buff->size;
+    if ((used + linesize) >= rl->term.col) {
+        linesize = used < rl->term.col ? rl->term.col - used - 1 : 0;
+    }
+
+    chry_readline_put(rl, rl->ln.buff->pbuf, linesize, -1);
+    chry_readline_put(rl, CHRY_READLINE_SEQ_ED0, sizeof(CHRY_READLINE_SEQ_ED0) - 1, -1);
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        enter reverse search mode
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int chry_readline_search_enter(chry_readline_t *rl)
+{
+#if defined(CONFIG_READLINE_HISTORY_STORE) && CONFIG_READLINE_HISTORY_STORE
+    if (rl->hist.lazy) {
+        chry_readline_history_restore(rl);
+    }
+#endif
+
+    if (rl->hist.index == 0) {
+        chry_readline_history_cache(rl);
+    }
+
+    rl->srch.active = 1;
+    rl->srch.fail = 0;
+    rl->srch.size = 0;
+    rl->srch.origin = rl->hist.index;
+
+    return chry_readline_search_refresh(rl);
+}
+
+/*****************************************************************************
+* @brief        leave reverse search mode, redraw prompt and line
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int chry_readline_search_leave(chry_readline_t *rl)
+{
+    rl->srch.active = 0;
+
+#if !(defined(CONFIG_READLINE_REFRESH_PROMPT) && CONFIG_READLINE_REFRESH_PROMPT)
+    /*!< move to line start */
+    chry_readline_put(rl, CHRY_READLINE_SEQ_CHA0, sizeof(CHRY_READLINE_SEQ_CHA0) - 1, -1);
+    /*!< output prompt */
+    chry_readline_put(rl, rl->prompt, rl->ln.pptlen, -1);
+#endif
+
+    return chry_readline_edit_refresh(rl);
+}
+
+/*****************************************************************************
+* @brief        append character to search pattern, search from current match
+*
+* @param[in]    rl          readline instance
+* @param[in]    c           printable character
+*
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int chry_readline_search_insert(chry_readline_t *rl, uint8_t c)
+{
+    if (rl->srch.size < sizeof(rl->srch.pattern)) {
+        rl->srch.pattern[rl->srch.size++] = c;
+
+        /*!< current match may still contain the longer pattern */
+        if (!rl->srch.fail) {
+            chry_readline_search_next(rl, rl->hist.index ? rl->hist.index : 1);
+        }
+    }
+
+    return chry_readline_search_refresh(rl);
+}
+
+/*****************************************************************************
+* @brief        handle control in reverse search mode
+*
+* @param[in]    rl          readline instance
+* @param[in]    exec        exec code
+*
+* @retval int               0:Accept and handle exec -1:Error 1:Consumed
+*****************************************************************************/
+static int chry_readline_search_exec(chry_readline_t *rl, uint8_t exec)
+{
+    switch (exec) {
+        case CHRY_READLINE_EXEC_NUL:
+            return 1;
+
+        case CHRY_READLINE_EXEC_SRCH:
+            /*!< next older match */
+            chry_readline_search_next(rl, rl->hist.index + 1);
+            return chry_readline_search_refresh(rl) ? -1 : 1;
+
+        case CHRY_READLINE_EXEC_BS:
+            if (rl->srch.size) {
+                rl->srch.size--;
+                rl->srch.fail = rl->hist.index ? !chry_readline_search_match(rl, rl->hist.index) : (rl->srch.size != 0);
+            }
+            return chry_readline_search_refresh(rl) ? -1 : 1;
+
+        case CHRY_READLINE_EXEC_ALN:
+        case CHRY_READLINE_EXEC_SIGINT_:
+            /*!< restore the line before search */
+            if (!chry_readline_history_fetch(rl, rl->srch.origin)) {
+                rl->ln.buff->size = 0;
+                rl->ln.curoff = 0;
+                rl->hist.index = 0;
+            }
+            return chry_readline_search_leave(rl) ? -1 : 1;
+
+        default:
+            return chry_readline_search_leave(rl) ? -1 : 0;
+    }
+}
+#endif
+
+#endif
+
+/*****************************************************************************
+* @brief        auto completion
+*
+* @param[in]    rl          readline instance
+*
+* @retval int               0:Success -1:Error 1:Restart
+*****************************************************************************/
+int chry_readline_complete(chry_readline_t *rl)
+{
+#if defined(CONFIG_READLINE_COMPLETION) && CONFIG_READLINE_COMPLETION
+    uint8_t count;
+    char *pre;
     uint16_t word_size;
 
     const char *argv[CONFIG_READLINE_MAX_COMPLETION];
@@ -1384,6 +2681,7 @@ static void chry_readline_calculate_prompt(chry_readline_t *rl)
     uint8_t flag;
 
     flag = 0;
+    rl->pptdirty = 0;
     rl->ln.pptlen = 0;
     rl->ln.pptoff = 0;
 
@@ -1422,12 +2720,219 @@ __unused static int chry_readline_wait_altscreen(chry_readline_t *rl)
     for (;;) {
         chry_readline_waitkey(rl, &c);
 
-        if ((c == CHRY_READLINE_C0_CR) || (c == CHRY_READLINE_C0_LF)) {
-            chry_readline_altscreen(rl, 1);
+        if ((c == CHRY_READLINE_C0_CR) || (c == CHRY_READLINE_C0_LF)) {
+            chry_readline_altscreen(rl, 1);
+            return 0;
+        }
+    }
+}
+
+#if defined(CONFIG_READLINE_BATCH) && CONFIG_READLINE_BATCH
+/*****************************************************************************
+* @brief        check if exec only edits the line, refresh can be deferred
+*****************************************************************************/
+static uint8_t chry_readline_batch_edit(uint8_t exec)
+{
+    switch (exec) {
+        case CHRY_READLINE_EXEC_NUL:
+        case CHRY_READLINE_EXEC_DEL:
+        case CHRY_READLINE_EXEC_BS:
+        case CHRY_READLINE_EXEC_MVRT:
+        case CHRY_READLINE_EXEC_MVLT:
+        case CHRY_READLINE_EXEC_MVED:
+        case CHRY_READLINE_EXEC_MVHM:
+        case CHRY_READLINE_EXEC_NXTH:
+        case CHRY_READLINE_EXEC_PRVH:
+        case CHRY_READLINE_EXEC_DLWD:
+        case CHRY_READLINE_EXEC_DHLN:
+        case CHRY_READLINE_EXEC_DELN:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/*****************************************************************************
+* @brief        stop deferring and output the deferred refresh
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int chry_readline_batch_flush(chry_readline_t *rl)
+{
+    rl->batch.defer = 0;
+
+    if (rl->batch.dirty) {
+        return chry_readline_edit_refresh(rl);
+    }
+
+    return 0;
+}
+#endif
+
+#if defined(CONFIG_READLINE_TYPEAHEAD) && CONFIG_READLINE_TYPEAHEAD
+/*****************************************************************************
+* @brief        keep a byte received in ignore mode for the next line,
+*               signal keys are left to the caller, sigint flushes queue
+*
+* @param[in]    rl          readline instance
+* @param[in]    c           received byte
+*
+* @retval int               1:kept or dropped 0:signal key
+*****************************************************************************/
+static int chry_readline_taput(chry_readline_t *rl, uint8_t c)
+{
+    uint8_t exec = c;
+
+    if ((CHRY_READLINE_G0_BEG > c) && (CHRY_READLINE_C0_ESC != c)) {
+        chry_readline_dispatch_ctrl(rl, &exec, rl->seq.pns);
+
+        if (exec == CHRY_READLINE_EXEC_SIGINT_) {
+            exec = CHRY_READLINE_EXEC_SIGINT;
+        }
+
+        if ((CHRY_READLINE_EXEC_SIGINT <= exec) && (exec <= CHRY_READLINE_EXEC_SIGTSTP)) {
+            if (exec == CHRY_READLINE_EXEC_SIGINT) {
+                /*!< interrupted, drop what was typed ahead */
+                rl->tah.out = rl->tah.in;
+            }
+            return 0;
+        }
+    }
+
+    /*!< not echoed, dropped when full */
+    if ((uint16_t)(rl->tah.in - rl->tah.out) < CONFIG_READLINE_TYPEAHEAD) {
+        rl->tah.pbuf[rl->tah.in & (CONFIG_READLINE_TYPEAHEAD - 1)] = c;
+        rl->tah.in++;
+    }
+
+    return 1;
+}
+#endif
+
+#if defined(CONFIG_READLINE_STATS) && CONFIG_READLINE_STATS
+/*****************************************************************************
+* @brief        count a received key, start timing when no earlier key
+*               is still waiting for its echo
+*
+* @param[in]    rl          readline instance
+*
+*****************************************************************************/
+static void chry_readline_stats_key(chry_readline_t *rl)
+{
+    if (rl->seq.state != CHRY_READLINE_DEC_IDLE) {
+        /*!< rest of a sequence, same key */
+        return;
+    }
+
+    rl->stats.keys++;
+
+    if (!rl->stats.wait && rl->stats.stamp) {
+        rl->stats.begin = rl->stats.stamp(rl);
+        rl->stats.nbyte = 0;
+        rl->stats.wait = 1;
+    }
+}
+
+/*****************************************************************************
+* @brief        stop timing once echo is out, called before waiting for
+*               the next key and after newline
+*
+* @param[in]    rl          readline instance
+*
+*****************************************************************************/
+static void chry_readline_stats_echo(chry_readline_t *rl)
+{
+    uint32_t latency;
+    uint8_t idx;
+
+    if (!rl->stats.wait || (rl->seq.state != CHRY_READLINE_DEC_IDLE)) {
+        return;
+    }
+
+#if defined(CONFIG_READLINE_BATCH) && CONFIG_READLINE_BATCH
+    if (rl->batch.dirty) {
+        /*!< echo deferred, keep timing */
+        return;
+    }
+#endif
+
+    rl->stats.wait = 0;
+
+    if (rl->stats.nbyte == 0) {
+        /*!< key without echo */
+        return;
+    }
+
+    latency = rl->stats.stamp(rl) - rl->stats.begin;
+
+    for (idx = 0; idx < (CHRY_READLINE_STATS_HIST - 1); idx++) {
+        if (latency < (16UL << (idx * 2))) {
+            break;
+        }
+    }
+
+    if ((rl->stats.echoes == 0) || (latency < rl->stats.min)) {
+        rl->stats.min = latency;
+    }
+    if (latency > rl->stats.max) {
+        rl->stats.max = latency;
+    }
+
+    rl->stats.echoes++;
+    rl->stats.bytes += rl->stats.nbyte;
+    rl->stats.sum += latency;
+    rl->stats.hist[idx]++;
+}
+#endif
+
+#if defined(CONFIG_READLINE_ESC_TIMEOUT) && CONFIG_READLINE_ESC_TIMEOUT
+/*****************************************************************************
+* @brief        get a key, give up waiting for the rest of an escape
+*               sequence when nothing arrives within timeout
+*
+* @param[in]    rl          readline instance
+* @param[out]   c           key
+*
+* @retval int               0:key or no input 1:lone esc
+*****************************************************************************/
+static int chry_readline_getkey_esc(chry_readline_t *rl, uint8_t *c)
+{
+    uint32_t elapsed;
+
+    if ((rl->seq.state != CHRY_READLINE_DEC_ESC) || (NULL == rl->clock)) {
+        chry_readline_getkey(rl, c);
+        return 0;
+    }
+
+    while (1) {
+        if (chry_readline_sget2(rl, c)) {
+#if defined(CONFIG_READLINE_NOBLOCK) && CONFIG_READLINE_NOBLOCK
+            rl->noblock = 0;
+#endif
+            return 0;
+        }
+
+        elapsed = rl->clock(rl) - rl->esctick;
+        if (elapsed >= CONFIG_READLINE_ESC_TIMEOUT) {
+#if defined(CONFIG_READLINE_NOBLOCK) && CONFIG_READLINE_NOBLOCK
+            rl->noblock = 0;
+#endif
+            return 1;
+        }
+
+#if defined(CONFIG_READLINE_NOBLOCK) && CONFIG_READLINE_NOBLOCK
+        if (!rl->block) {
+            /*!< checked again on next call */
+            rl->noblock = 1;
             return 0;
         }
+#endif
+
+        if (rl->wait) {
+            rl->wait(rl, CONFIG_READLINE_ESC_TIMEOUT - elapsed);
+        }
     }
 }
+#endif
 
 /*****************************************************************************
 * @brief        readline internal
@@ -1453,6 +2958,14 @@ static char *chry_readline_inernal(chry_readline_t *rl)
 
 restart:
 
+#if defined(CONFIG_READLINE_PASTE) && CONFIG_READLINE_PASTE
+    if (!rl->paste.enable) {
+        /*!< enable bracketed paste mode */
+        chry_readline_put(rl, "\e[?2004h", 8, NULL);
+        rl->paste.enable = 1;
+    }
+#endif
+
     if (rl->auto_refresh) {
 #if defined(CONFIG_READLINE_REFRESH_PROMPT) && CONFIG_READLINE_REFRESH_PROMPT
         if (chry_readline_edit_refresh(rl)) {
@@ -1470,7 +2983,9 @@ restart:
 
     while (1) {
         uint8_t c = 0;
-        uint16_t pn[4];
+#if defined(CONFIG_READLINE_ESC_TIMEOUT) && CONFIG_READLINE_ESC_TIMEOUT
+        int lone;
+#endif
 
 #if defined(CONFIG_READLINE_XTERM) && CONFIG_READLINE_XTERM
         /*!< wait switch to altscreen */
@@ -1483,25 +2998,93 @@ restart:
     restore:
 #endif
 
+#if defined(CONFIG_READLINE_BATCH) && CONFIG_READLINE_BATCH
+        /*!< input drained, output the deferred refresh before waiting */
+        if (!chry_readline_pending(rl)) {
+            if (chry_readline_batch_flush(rl)) {
+                return NULL;
+            }
+        }
+#endif
+
+#if defined(CONFIG_READLINE_TXQUEUE) && CONFIG_READLINE_TXQUEUE
+        /*!< retry output left by short write */
+        chry_readline_txflush(rl);
+#endif
+
+#if defined(CONFIG_READLINE_STATS) && CONFIG_READLINE_STATS
+        chry_readline_stats_echo(rl);
+#endif
+
         /*!< get a key */
+#if defined(CONFIG_READLINE_ESC_TIMEOUT) && CONFIG_READLINE_ESC_TIMEOUT
+        lone = chry_readline_getkey_esc(rl, &c);
+#else
         chry_readline_getkey(rl, &c);
+#endif
 
 #if defined(CONFIG_READLINE_NOBLOCK) && CONFIG_READLINE_NOBLOCK
-        if (rl->noblock && !rl->block) {
-            return NULL;
+        if (rl->noblock) {
+            if (!rl->block) {
+                return NULL;
+            }
+            /*!< no key, do not feed the decoder */
+            continue;
         }
 #endif
 
-        if (c & 0x80) {
-            /*!< not support 8bit code */
-            continue;
+#if defined(CONFIG_READLINE_TYPEAHEAD) && CONFIG_READLINE_TYPEAHEAD
+        if (rl->ignore && (rl->seq.state == CHRY_READLINE_DEC_IDLE)) {
+            if (chry_readline_taput(rl, c)) {
+                continue;
+            }
         }
+#endif
+
+#if defined(CONFIG_READLINE_BATCH) && CONFIG_READLINE_BATCH
+        rl->batch.defer = 1;
+#endif
+
+#if defined(CONFIG_READLINE_STATS) && CONFIG_READLINE_STATS
+        chry_readline_stats_key(rl);
+#endif
+
+#if defined(CONFIG_READLINE_ESC_TIMEOUT) && CONFIG_READLINE_ESC_TIMEOUT
+        if (lone) {
+            /*!< no continuation in time, esc key pressed alone */
+            rl->seq.state = CHRY_READLINE_DEC_IDLE;
+            c = CHRY_READLINE_CTRLMAP_ESC;
+            if (chry_readline_dispatch_ctrl(rl, &c, rl->seq.pns)) {
+                return NULL;
+            }
+            goto dispatched;
+        }
+#endif
 
-        if (CHRY_READLINE_G0_BEG <= c) {
+        if (rl->seq.state) {
+            /*!< resume sequence split across calls */
+            int ret = chry_readline_seqexec(rl, &c);
+            if (ret < 0) {
+                return NULL;
+            } else if (ret > 0) {
+                continue;
+            }
+        } else if (c & 0x80) {
+            /*!< not support 8bit code */
+            continue;
+        } else if (CHRY_READLINE_G0_BEG <= c) {
             if (c <= CHRY_READLINE_G0_END) {
                 if (rl->ignore) {
                     continue;
                 }
+#if defined(CONFIG_READLINE_HISTORY) && CONFIG_READLINE_HISTORY && defined(CONFIG_READLINE_HISTORY_SEARCH) && CONFIG_READLINE_HISTORY_SEARCH
+                if (rl->srch.active) {
+                    if (chry_readline_search_insert(rl, c)) {
+                        return NULL;
+                    }
+                    continue;
+                }
+#endif
                 /*!< printable characters */
                 if (chry_readline_edit_insert(rl, c)) {
                     return NULL;
@@ -1512,15 +3095,21 @@ restart:
                 c = CHRY_READLINE_EXEC_BS;
             }
         } else if (CHRY_READLINE_C0_ESC == c) {
-            if (chry_readline_seqexec(rl, &c, pn)) {
-                return NULL;
-            }
+            /*!< decoded byte by byte on next keys */
+            rl->seq.state = CHRY_READLINE_DEC_ESC;
+#if defined(CONFIG_READLINE_ESC_TIMEOUT) && CONFIG_READLINE_ESC_TIMEOUT
+            rl->esctick = rl->clock ? rl->clock(rl) : 0;
+#endif
+            continue;
         } else {
-            if (chry_readline_dispatch_ctrl(rl, &c, pn)) {
+            if (chry_readline_dispatch_ctrl(rl, &c, rl->seq.pns)) {
                 return NULL;
             }
         }
 
+#if defined(CONFIG_READLINE_ESC_TIMEOUT) && CONFIG_READLINE_ESC_TIMEOUT
+    dispatched:
+#endif
         if (rl->ignore) {
             if (c == CHRY_READLINE_EXEC_SIGINT_) {
                 c = CHRY_READLINE_EXEC_SIGINT;
@@ -1531,6 +3120,26 @@ restart:
             }
         }
 
+#if defined(CONFIG_READLINE_BATCH) && CONFIG_READLINE_BATCH
+        /*!< line must be on screen before newline, completion or callback */
+        if (!chry_readline_batch_edit(c)) {
+            if (chry_readline_batch_flush(rl)) {
+                return NULL;
+            }
+        }
+#endif
+
+#if defined(CONFIG_READLINE_HISTORY) && CONFIG_READLINE_HISTORY && defined(CONFIG_READLINE_HISTORY_SEARCH) && CONFIG_READLINE_HISTORY_SEARCH
+        if (rl->srch.active) {
+            int ret = chry_readline_search_exec(rl, c);
+            if (ret < 0) {
+                return NULL;
+            } else if (ret > 0) {
+                continue;
+            }
+        }
+#endif
+
     rehandle:
         /*!< hanlde control */
         switch (c) {
@@ -1549,6 +3158,15 @@ restart:
             case CHRY_READLINE_EXEC_NLN:
 #if defined(CONFIG_READLINE_HISTORY) && CONFIG_READLINE_HISTORY
                 if (!rl->ln.mask) {
+#if defined(CONFIG_READLINE_HISTORY_EXPAND) && CONFIG_READLINE_HISTORY_EXPAND
+                    int ret = chry_readline_history_expand(rl);
+                    if (ret < 0) {
+                        return NULL;
+                    } else if (ret > 0) {
+                        rl->ln.buff->size = 0;
+                        return rl->ln.buff->pbuf;
+                    }
+#endif
                     chry_readline_history_store(rl);
                 }
 #endif
@@ -1703,6 +3321,17 @@ restart:
                 rl->ln.buff->size = 0;
                 return rl->ln.buff->pbuf;
 
+            /*!< reverse search history */
+            case CHRY_READLINE_EXEC_SRCH:
+#if defined(CONFIG_READLINE_HISTORY) && CONFIG_READLINE_HISTORY && defined(CONFIG_READLINE_HISTORY_SEARCH) && CONFIG_READLINE_HISTORY_SEARCH
+                if (!rl->ln.mask) {
+                    if (chry_readline_search_enter(rl)) {
+                        return NULL;
+                    }
+                }
+#endif
+                break;
+
             case CHRY_READLINE_EXEC_EOF_:
                 if (rl->ln.buff->size == 0) {
                     c = CHRY_READLINE_EXEC_EOF;
@@ -1799,65 +3428,392 @@ __unused static uint8_t chry_readline_sgrset(char *buf, uint16_t sgrraw)
     size_t idx = 0;
     chry_readline_seqgen_csi((void *)buf, &idx);
 
-    if (sgrraw == 0) {
-        buf[idx++] = 'm';
-        buf[idx] = '\0';
-        return idx;
-    }
+    if (sgrraw == 0) {
+        buf[idx++] = 'm';
+        buf[idx] = '\0';
+        return idx;
+    }
+
+    if (sgr.bold) {
+        buf[idx + 0] = '1';
+        buf[idx + 1] = ';';
+        idx += 2;
+    }
+
+    if (sgr.underline) {
+        buf[idx + 0] = '4';
+        buf[idx + 1] = ';';
+        idx += 2;
+    }
+
+    if (sgr.blink) {
+        buf[idx + 0] = '5';
+        buf[idx + 1] = ';';
+        idx += 2;
+    }
+
+    if (sgr.inverse) {
+        buf[idx + 0] = '8';
+        buf[idx + 1] = ';';
+        idx += 2;
+    }
+
+    if (sgr.foreground) {
+        buf[idx + 0] = '3';
+        buf[idx + 1] = '0' + (sgr.foreground - 1);
+        buf[idx + 2] = ';';
+        idx += 3;
+    }
+
+    if (sgr.background) {
+        buf[idx + 0] = '4';
+        buf[idx + 1] = '0' + (sgr.background - 1);
+        buf[idx + 2] = ';';
+        idx += 3;
+    }
+
+    buf[idx - 1] = 'm';
+    buf[idx] = '\0';
+
+    return idx;
+}
+
+/*****************************************************************************
+* @brief        output CONFIG_READLINE_NEWLINE
+*
+* @param[in]    rl          readline instance
+*
+*****************************************************************************/
+void chry_readline_newline(chry_readline_t *rl)
+{
+    chry_readline_put(rl, CONFIG_READLINE_NEWLINE, sizeof(CONFIG_READLINE_NEWLINE) ? sizeof(CONFIG_READLINE_NEWLINE) - 1 : 0, );
+}
+
+#if defined(CONFIG_READLINE_PAGER) && CONFIG_READLINE_PAGER
+/*****************************************************************************
+* @brief        output pager data
+*****************************************************************************/
+static void chry_readline_pager_put(chry_readline_t *rl, const void *data, uint16_t size)
+{
+    if (size) {
+        chry_readline_put(rl, data, size, );
+    }
+}
+
+/*****************************************************************************
+* @brief        wait pager key
+*****************************************************************************/
+static uint8_t chry_readline_pager_getc(chry_readline_t *rl)
+{
+    uint8_t c;
+
+#if defined(CONFIG_READLINE_TXQUEUE) && CONFIG_READLINE_TXQUEUE
+    /*!< prompt must be on the wire before waiting */
+    while (chry_readline_txflush(rl)) {
+    }
+#endif
+
+    chry_readline_waitkey(rl, &c);
+    return c;
+}
+
+/*****************************************************************************
+* @brief        read search pattern after '/'
+*****************************************************************************/
+static void chry_readline_pager_pattern(chry_readline_t *rl)
+{
+    uint8_t c;
+
+    rl->pager.patlen = 0;
+    chry_readline_pager_put(rl, "/", 1);
+
+    while (1) {
+        c = chry_readline_pager_getc(rl);
+
+        if ((c == '\r') || (c == '\n')) {
+            break;
+        } else if ((c == CHRY_READLINE_C0_BS) || (c == CHRY_READLINE_C0_DEL)) {
+            if (rl->pager.patlen) {
+                rl->pager.patlen--;
+                chry_readline_pager_put(rl, "\b \b", 3);
+            }
+        } else if ((c == CHRY_READLINE_C0_ETX) || (c == CHRY_READLINE_C0_ESC)) {
+            rl->pager.patlen = 0;
+            break;
+        } else if ((c >= ' ') && (rl->pager.patlen < sizeof(rl->pager.pattern) - 1)) {
+            rl->pager.pattern[rl->pager.patlen++] = c;
+            chry_readline_pager_put(rl, &c, 1);
+        }
+    }
+
+    rl->pager.pattern[rl->pager.patlen] = '\0';
+    rl->pager.search = rl->pager.patlen != 0;
+    rl->pager.lnlen = 0;
+}
+
+/*****************************************************************************
+* @brief        show pager prompt on last row and wait for command
+*****************************************************************************/
+static void chry_readline_pager_wait(chry_readline_t *rl)
+{
+    uint8_t c;
+
+#if defined(CONFIG_READLINE_LEAN) && CONFIG_READLINE_LEAN
+    if (rl->lean) {
+        chry_readline_pager_put(rl, "--More--", 8);
+    } else
+#endif
+    {
+        chry_readline_pager_put(rl, "\e[7m--More--\e[m", 15);
+    }
+
+    while (1) {
+        c = chry_readline_pager_getc(rl);
+
+        if (c == ' ') {
+            /*!< next page */
+            rl->pager.line = 0;
+            break;
+        } else if ((c == '\r') || (c == '\n')) {
+            /*!< next line */
+            rl->pager.line = rl->term.row - 2;
+            break;
+        } else if ((c == 'q') || (c == 'Q') || (c == CHRY_READLINE_C0_ETX)) {
+            /*!< discard rest of output */
+            rl->pager.quit = 1;
+            break;
+        } else if (c == '/') {
+            chry_readline_pager_put(rl, "\r\e[K", 4);
+            chry_readline_pager_pattern(rl);
+            rl->pager.line = 0;
+            break;
+        }
+    }
+
+    /*!< erase pager prompt */
+    chry_readline_pager_put(rl, "\r\e[K", 4);
+    rl->pager.col = 0;
+}
+
+/*****************************************************************************
+* @brief        buffer line while searching, output it once pattern matched
+*
+* @retval                   1 if pattern matched
+*****************************************************************************/
+static uint8_t chry_readline_pager_match(chry_readline_t *rl, uint8_t c)
+{
+    if (c == '\n') {
+        rl->pager.lnbuf[rl->pager.lnlen] = '\0';
+
+        if (strstr(rl->pager.lnbuf, rl->pager.pattern)) {
+            chry_readline_pager_put(rl, rl->pager.lnbuf, rl->pager.lnlen);
+            chry_readline_newline(rl);
+            rl->pager.search = 0;
+            rl->pager.line = 1;
+            rl->pager.col = 0;
+            rl->pager.esc = 0;
+        }
+
+        rl->pager.lnlen = 0;
+        return !rl->pager.search;
+    }
+
+    /*!< longer lines are matched and shown truncated */
+    if ((c != '\r') && (rl->pager.lnlen < CONFIG_READLINE_PAGER)) {
+        rl->pager.lnbuf[rl->pager.lnlen++] = c;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        write through pager, count lines and stop every screen
+*****************************************************************************/
+static void chry_readline_pager_write(chry_readline_t *rl, const uint8_t *data, uint16_t size)
+{
+    uint16_t start = 0;
+    uint16_t rows = rl->term.row - 1;
+
+    for (uint16_t i = 0; (i < size) && !rl->pager.quit; i++) {
+        uint8_t c = data[i];
+
+        if (rl->pager.search) {
+            chry_readline_pager_match(rl, c);
+            start = i + 1;
+            continue;
+        }
+
+        if (rl->pager.esc) {
+            /*!< skip escape sequence, it takes no column */
+            if ((rl->pager.esc == 1) && (c == '[')) {
+                rl->pager.esc = 2;
+            } else if ((rl->pager.esc == 1) || ((c >= 0x40) && (c <= 0x7e))) {
+                rl->pager.esc = 0;
+            }
+            continue;
+        }
+
+        if (c == CHRY_READLINE_C0_ESC) {
+            rl->pager.esc = 1;
+            continue;
+        } else if (c == '\r') {
+            rl->pager.col = 0;
+            continue;
+        } else if (c != '\n') {
+            if ((c < ' ') || (c == CHRY_READLINE_C0_DEL) || ((c & 0xc0) == 0x80)) {
+                /*!< control and utf-8 continuation bytes take no column */
+                continue;
+            }
+
+            if (rl->pager.col < rl->term.col) {
+                rl->pager.col++;
+                continue;
+            }
+
+            /*!< auto wrap, this char starts the next line */
+            rl->pager.col = 1;
+            rl->pager.line++;
+
+            if (rl->pager.line >= rows) {
+                chry_readline_pager_put(rl, &data[start], i - start);
+                start = i;
+                chry_readline_pager_wait(rl);
+                rl->pager.col = 1;
+            }
+            continue;
+        }
+
+        rl->pager.col = 0;
+        rl->pager.line++;
+
+        if (rl->pager.line >= rows) {
+            chry_readline_pager_put(rl, &data[start], i + 1 - start);
+            start = i + 1;
+            chry_readline_pager_wait(rl);
+        }
+    }
+
+    if (!rl->pager.quit && !rl->pager.search) {
+        chry_readline_pager_put(rl, &data[start], size - start);
+    }
+}
+#endif
+
+/*****************************************************************************
+* @brief        output write data to pager or wire
+*****************************************************************************/
+static uint16_t chry_readline_write_out(chry_readline_t *rl, const void *data, uint16_t size)
+{
+    if (size == 0) {
+        return 0;
+    }
+
+#if defined(CONFIG_READLINE_PAGER) && CONFIG_READLINE_PAGER
+    if (rl->pager.enable && (rl->term.row > 1)) {
+        chry_readline_pager_write(rl, data, size);
+        return size;
+    }
+#endif
+
+#if defined(CONFIG_READLINE_TXQUEUE) && CONFIG_READLINE_TXQUEUE
+    chry_readline_txput(rl, data, size);
+    return size;
+#else
+    return rl->sput(rl, data, size);
+#endif
+}
+
+#if defined(CONFIG_READLINE_LEAN) && CONFIG_READLINE_LEAN
+/*****************************************************************************
+* @brief        drop SGR sequences from write data in lean mode,
+*               sequences split across writes are held until complete
+*****************************************************************************/
+static void chry_readline_sgr_filter(chry_readline_t *rl, const uint8_t *data, uint16_t size)
+{
+    uint8_t buf[64];
+    uint16_t len = 0;
+
+    for (uint16_t i = 0; i < size; i++) {
+        uint8_t c = data[i];
 
-    if (sgr.bold) {
-        buf[idx + 0] = '1';
-        buf[idx + 1] = ';';
-        idx += 2;
-    }
+        if (len > sizeof(buf) - sizeof(rl->sgrf.hold)) {
+            chry_readline_write_out(rl, buf, len);
+            len = 0;
+        }
 
-    if (sgr.underline) {
-        buf[idx + 0] = '4';
-        buf[idx + 1] = ';';
-        idx += 2;
+        if (rl->sgrf.state == 0) {
+            if (c == CHRY_READLINE_C0_ESC) {
+                rl->sgrf.hold[0] = c;
+                rl->sgrf.len = 1;
+                rl->sgrf.state = 1;
+            } else {
+                buf[len++] = c;
+            }
+        } else if ((rl->sgrf.state == 1) && (c == '[')) {
+            rl->sgrf.hold[rl->sgrf.len++] = c;
+            rl->sgrf.state = 2;
+        } else if ((rl->sgrf.state == 2) && (c == 'm')) {
+            /*!< drop sgr sequence */
+            rl->sgrf.state = 0;
+        } else if ((rl->sgrf.state == 2) && (rl->sgrf.len < sizeof(rl->sgrf.hold)) &&
+                   (((c >= '0') && (c <= '9')) || (c == ';'))) {
+            rl->sgrf.hold[rl->sgrf.len++] = c;
+        } else {
+            /*!< not sgr, pass held bytes and process this char again */
+            memcpy(&buf[len], rl->sgrf.hold, rl->sgrf.len);
+            len += rl->sgrf.len;
+            rl->sgrf.state = 0;
+            i--;
+        }
     }
 
-    if (sgr.blink) {
-        buf[idx + 0] = '5';
-        buf[idx + 1] = ';';
-        idx += 2;
-    }
+    chry_readline_write_out(rl, buf, len);
+}
+#endif
 
-    if (sgr.inverse) {
-        buf[idx + 0] = '8';
-        buf[idx + 1] = ';';
-        idx += 2;
-    }
+/*****************************************************************************
+* @brief        output data through readline, use this instead of sput
+*               to keep order with queued bytes
+*
+* @param[in]    rl          readline instance
+* @param[in]    data        data pointer
+* @param[in]    size        data size
+*
+* @retval                   size accepted
+*****************************************************************************/
+uint16_t chry_readline_write(chry_readline_t *rl, const void *data, uint16_t size)
+{
+    CHRY_READLINE_PARAM_CHECK(NULL != rl, 0);
 
-    if (sgr.foreground) {
-        buf[idx + 0] = '3';
-        buf[idx + 1] = '0' + (sgr.foreground - 1);
-        buf[idx + 2] = ';';
-        idx += 3;
-    }
+#if defined(CONFIG_READLINE_LEAN) && CONFIG_READLINE_LEAN
+    rl->drawn = 0;
 
-    if (sgr.background) {
-        buf[idx + 0] = '4';
-        buf[idx + 1] = '0' + (sgr.background - 1);
-        buf[idx + 2] = ';';
-        idx += 3;
+    if (rl->lean) {
+        chry_readline_sgr_filter(rl, data, size);
+        return size;
     }
+#endif
 
-    buf[idx - 1] = 'm';
-    buf[idx] = '\0';
-
-    return idx;
+    return chry_readline_write_out(rl, data, size);
 }
 
 /*****************************************************************************
-* @brief        output CONFIG_READLINE_NEWLINE
+* @brief        retry bytes kept in txqueue
 *
 * @param[in]    rl          readline instance
 *
+* @retval                   bytes still queued
 *****************************************************************************/
-void chry_readline_newline(chry_readline_t *rl)
+uint16_t chry_readline_poll_tx(chry_readline_t *rl)
 {
-    chry_readline_put(rl, CONFIG_READLINE_NEWLINE, sizeof(CONFIG_READLINE_NEWLINE) ? sizeof(CONFIG_READLINE_NEWLINE) - 1 : 0, );
+    CHRY_READLINE_PARAM_CHECK(NULL != rl, 0);
+
+#if defined(CONFIG_READLINE_TXQUEUE) && CONFIG_READLINE_TXQUEUE
+    return chry_readline_txflush(rl);
+#else
+    (void)rl;
+    return 0;
+#endif
 }
 
 /*****************************************************************************
@@ -1937,6 +3893,68 @@ void chry_readline_mask(chry_readline_t *rl, uint8_t enable)
     }
 }
 
+/*****************************************************************************
+* @brief        enable or disable lean wire mode, SGR is dropped from
+*               prompt and write output, prompt is redrawn only when needed.
+*               SGR of existing prompt segments is stripped on enable,
+*               re-edit segments to restore colors after disable
+*
+* @param[in]    rl          readline instance
+* @param[in]    enable      lean enable
+*
+*****************************************************************************/
+void chry_readline_lean(chry_readline_t *rl, uint8_t enable)
+{
+    CHRY_READLINE_PARAM_CHECK(NULL != rl, );
+
+#if defined(CONFIG_READLINE_LEAN) && CONFIG_READLINE_LEAN
+    rl->lean = enable ? 1 : 0;
+    rl->drawn = 0;
+    rl->sgrf.state = 0;
+
+#if defined(CONFIG_READLINE_PROMPTEDIT) && CONFIG_READLINE_PROMPTEDIT
+    if (rl->lean) {
+        uint16_t in = 0;
+        uint16_t out = 0;
+
+        for (uint8_t i = 0; (i < CONFIG_READLINE_PROMPTSEG) && rl->pptseglen[i]; i++) {
+            uint16_t end = in + rl->pptseglen[i];
+            uint16_t segout = out;
+
+            while (in < end) {
+                if ((rl->prompt[in] == '\e') && (in + 1 < end) && (rl->prompt[in + 1] == '[')) {
+                    uint16_t j = in + 2;
+
+                    while ((j < end) && (((rl->prompt[j] >= '0') && (rl->prompt[j] <= '9')) || (rl->prompt[j] == ';'))) {
+                        j++;
+                    }
+
+                    if ((j < end) && (rl->prompt[j] == 'm')) {
+                        in = j + 1;
+                        continue;
+                    }
+                }
+
+                rl->prompt[out++] = rl->prompt[in++];
+            }
+
+            rl->pptseglen[i] = out - segout;
+        }
+
+        rl->prompt[out] = '\0';
+    }
+#endif
+
+    rl->pptdirty = 1;
+    if (NULL != rl->ln.buff) {
+        chry_readline_calculate_prompt(rl);
+    }
+#else
+    (void)rl;
+    (void)enable;
+#endif
+}
+
 /*****************************************************************************
 * @brief        readline
 *
@@ -1970,15 +3988,23 @@ char *chry_readline(chry_readline_t *rl, char *linebuff, uint16_t buffsize, uint
 
 #if defined(CONFIG_READLINE_HISTORY) && CONFIG_READLINE_HISTORY
     rl->hist.index = 0;
+#if defined(CONFIG_READLINE_HISTORY_PREFIX) && CONFIG_READLINE_HISTORY_PREFIX
+    rl->hist.plen = 0;
+#endif
+#if defined(CONFIG_READLINE_HISTORY_SEARCH) && CONFIG_READLINE_HISTORY_SEARCH
+    rl->srch.active = 0;
+#endif
 #endif
-
-    /*!< calculate prompt offset and size */
-    chry_readline_calculate_prompt(rl);
 
 #if defined(CONFIG_READLINE_NOBLOCK) && CONFIG_READLINE_NOBLOCK
 restore:
 #endif
 
+    /*!< calculate prompt offset and size, only after prompt changed */
+    if (rl->pptdirty) {
+        chry_readline_calculate_prompt(rl);
+    }
+
     ret = chry_readline_inernal(rl);
 
 #if defined(CONFIG_READLINE_NOBLOCK) && CONFIG_READLINE_NOBLOCK
@@ -1990,6 +4016,10 @@ restore:
     /*!< new line */
     chry_readline_put(rl, CONFIG_READLINE_NEWLINE, sizeof(CONFIG_READLINE_NEWLINE) ? sizeof(CONFIG_READLINE_NEWLINE) - 1 : 0, NULL);
 
+#if defined(CONFIG_READLINE_STATS) && CONFIG_READLINE_STATS
+    chry_readline_stats_echo(rl);
+#endif
+
     if (NULL != linesize) {
         *linesize = rl->ln.buff->size;
     }
@@ -2000,6 +4030,40 @@ restore:
     return ret;
 }
 
+#if defined(CONFIG_READLINE_NOBLOCK) && CONFIG_READLINE_NOBLOCK
+/*****************************************************************************
+* @brief        readline on pushed input, sget is not called.
+*               bytes after a completed line are left for the next call
+*
+* @param[in]    rl          readline instance
+* @param[in]    linebuff    linebuff pointer
+* @param[in]    buffsize    linebuff size
+* @param[in]    linesize    readline size (set NULL to ignore)
+* @param[in]    data        input bytes
+* @param[inout] size        input size, return used size
+*
+* @retval char*             line pointer, (void *)-1 need more input
+*****************************************************************************/
+char *chry_readline_feed(chry_readline_t *rl, char *linebuff, uint16_t buffsize, uint16_t *linesize, const void *data, uint16_t *size)
+{
+    char *ret;
+    CHRY_READLINE_PARAM_CHECK(NULL != rl, NULL);
+    CHRY_READLINE_PARAM_CHECK(NULL != data, NULL);
+    CHRY_READLINE_PARAM_CHECK(NULL != size, NULL);
+
+    rl->feed.data = data;
+    rl->feed.size = *size;
+    rl->feed.pos = 0;
+
+    ret = chry_readline(rl, linebuff, buffsize, linesize);
+
+    *size = rl->feed.pos;
+    rl->feed.data = NULL;
+
+    return ret;
+}
+#endif
+
 /*****************************************************************************
 * @brief        init readline
 *
@@ -2034,6 +4098,14 @@ int chry_readline_init(chry_readline_t *rl, chry_readline_init_t *init)
     rl->hist.mask = init->histsize - 1;
     rl->hist.size = init->histsize;
     rl->hist.cache = 0;
+    rl->hist.iin = 0;
+    rl->hist.iout = 0;
+#if defined(CONFIG_READLINE_HISTORY_STORE) && CONFIG_READLINE_HISTORY_STORE
+    rl->hist.lazy = 0;
+    rl->hist.saved = 0;
+    rl->hist.hsave = NULL;
+    rl->hist.hread = NULL;
+#endif
 #endif
 
 #if defined(CONFIG_READLINE_COMPLETION) && CONFIG_READLINE_COMPLETION
@@ -2054,9 +4126,57 @@ int chry_readline_init(chry_readline_t *rl, chry_readline_init_t *init)
     rl->ln.pptsize = init->pptsize;
 
     rl->ucb = NULL;
+    rl->wait = NULL;
+
+#if defined(CONFIG_READLINE_ESC_TIMEOUT) && CONFIG_READLINE_ESC_TIMEOUT
+    rl->clock = NULL;
+    rl->esctick = 0;
+#endif
 
     rl->ignore = false;
     rl->auto_refresh = true;
+    rl->pptdirty = true;
+    rl->seq.state = 0;
+
+#if defined(CONFIG_READLINE_LEAN) && CONFIG_READLINE_LEAN
+    rl->lean = false;
+    rl->drawn = false;
+    rl->sgrf.state = 0;
+#endif
+
+#if defined(CONFIG_READLINE_PASTE) && CONFIG_READLINE_PASTE
+    rl->paste.enable = 0;
+#endif
+
+#if defined(CONFIG_READLINE_BATCH) && CONFIG_READLINE_BATCH
+    rl->batch.savail = NULL;
+    rl->batch.defer = 0;
+    rl->batch.dirty = 0;
+    rl->batch.count = 0;
+#endif
+
+#if defined(CONFIG_READLINE_INBUFF) && CONFIG_READLINE_INBUFF
+    rl->inb.pos = 0;
+    rl->inb.len = 0;
+#endif
+
+#if defined(CONFIG_READLINE_STATS) && CONFIG_READLINE_STATS
+    rl->stats.stamp = NULL;
+    chry_readline_stats_reset(rl);
+#endif
+
+#if defined(CONFIG_READLINE_TYPEAHEAD) && CONFIG_READLINE_TYPEAHEAD
+    rl->tah.in = 0;
+    rl->tah.out = 0;
+#endif
+
+#if defined(CONFIG_READLINE_PEEK) && CONFIG_READLINE_PEEK
+    rl->peek.speek = NULL;
+    rl->peek.scommit = NULL;
+    rl->peek.pdata = NULL;
+    rl->peek.pos = 0;
+    rl->peek.len = 0;
+#endif
 
 #if defined(CONFIG_READLINE_CTRLMAP) && CONFIG_READLINE_CTRLMAP
     memcpy(rl->ctrlmap, ctrlmap, sizeof(ctrlmap));
@@ -2069,6 +4189,12 @@ int chry_readline_init(chry_readline_t *rl, chry_readline_init_t *init)
 #if defined(CONFIG_READLINE_NOBLOCK) && CONFIG_READLINE_NOBLOCK
     rl->noblock = false;
     rl->block = false;
+    rl->feed.data = NULL;
+#endif
+
+#if defined(CONFIG_READLINE_TXQUEUE) && CONFIG_READLINE_TXQUEUE
+    rl->txq.in = 0;
+    rl->txq.out = 0;
 #endif
 
     return 0;
@@ -2083,7 +4209,6 @@ int chry_readline_init(chry_readline_t *rl, chry_readline_init_t *init)
 void chry_readline_detect(chry_readline_t *rl)
 {
     uint8_t c;
-    uint16_t pn[4];
 
     /*!< test sput and get screen size */
     if (5 != rl->sput(rl, "\e[18t", 5)) {
@@ -2093,8 +4218,12 @@ void chry_readline_detect(chry_readline_t *rl)
     chry_readline_waitkey(rl, &c);
 
     if (c == CHRY_READLINE_C0_ESC) {
-        /*!< execute sequence */
-        chry_readline_seqexec(rl, &c, pn);
+        /*!< execute sequence, blocked until complete */
+        rl->seq.state = CHRY_READLINE_DEC_ESC;
+
+        do {
+            chry_readline_waitkey(rl, &c);
+        } while (chry_readline_seqexec(rl, &c) > 0);
     }
 }
 
@@ -2126,6 +4255,151 @@ void chry_readline_set_user_cb(chry_readline_t *rl, int (*ucb)(chry_readline_t *
     rl->ucb = ucb;
 }
 
+/*****************************************************************************
+* @brief        set input wait callback, called when sget returns no data
+*               in blocking read. block on semaphore, event, wfi or poll
+*               until input arrives or timeout (ms) expires
+*
+* @param[in]    rl          readline instance
+* @param[in]    wait        callback, return 0:woken other:timeout
+*
+*****************************************************************************/
+void chry_readline_set_wait_cb(chry_readline_t *rl, int (*wait)(chry_readline_t *rl, uint32_t timeout))
+{
+    rl->wait = wait;
+}
+
+/*****************************************************************************
+* @brief        set millisecond tick callback, used to tell a lone esc key
+*               from the start of an escape sequence, may wrap around
+*
+* @param[in]    rl          readline instance
+* @param[in]    clock       callback
+*
+*****************************************************************************/
+void chry_readline_set_clock_cb(chry_readline_t *rl, uint32_t (*clock)(chry_readline_t *rl))
+{
+    (void)rl;
+    (void)clock;
+#if defined(CONFIG_READLINE_ESC_TIMEOUT) && CONFIG_READLINE_ESC_TIMEOUT
+    rl->clock = clock;
+#endif
+}
+
+/*****************************************************************************
+* @brief        set timestamp callback for key to echo latency statistics,
+*               microseconds recommended, histogram buckets assume it
+*
+* @param[in]    rl          readline instance
+* @param[in]    stamp       callback, may wrap around
+*
+*****************************************************************************/
+void chry_readline_set_stamp_cb(chry_readline_t *rl, uint32_t (*stamp)(chry_readline_t *rl))
+{
+    (void)rl;
+    (void)stamp;
+#if defined(CONFIG_READLINE_STATS) && CONFIG_READLINE_STATS
+    rl->stats.stamp = stamp;
+    rl->stats.wait = 0;
+#endif
+}
+
+/*****************************************************************************
+* @brief        clear key to echo latency statistics
+*
+* @param[in]    rl          readline instance
+*
+*****************************************************************************/
+void chry_readline_stats_reset(chry_readline_t *rl)
+{
+    (void)rl;
+#if defined(CONFIG_READLINE_STATS) && CONFIG_READLINE_STATS
+    uint8_t i;
+
+    rl->stats.begin = 0;
+    rl->stats.nbyte = 0;
+    rl->stats.wait = 0;
+    rl->stats.keys = 0;
+    rl->stats.echoes = 0;
+    rl->stats.bytes = 0;
+    rl->stats.min = 0;
+    rl->stats.max = 0;
+    rl->stats.sum = 0;
+
+    for (i = 0; i < CHRY_READLINE_STATS_HIST; i++) {
+        rl->stats.hist[i] = 0;
+    }
+#endif
+}
+
+/*****************************************************************************
+* @brief        set history storage callbacks, hsave appends a stored line to
+*               the log, hread reads records from newest to oldest and returns
+*               the line size or -1 when no older record, longer records are
+*               truncated to size. *cursor is 0 on the first read, the backend
+*               keeps its position in it. stored history is loaded into the
+*               ring on first history browse, not here
+*
+* @param[in]    rl          readline instance
+* @param[in]    hsave       append callback
+* @param[in]    hread       read callback
+*
+*****************************************************************************/
+void chry_readline_set_histstore_cb(chry_readline_t *rl,
+                                    void (*hsave)(chry_readline_t *rl, const char *line, uint16_t size),
+                                    int (*hread)(chry_readline_t *rl, uint32_t *cursor, char *line, uint16_t size))
+{
+    (void)rl;
+    (void)hsave;
+    (void)hread;
+#if defined(CONFIG_READLINE_HISTORY) && CONFIG_READLINE_HISTORY && defined(CONFIG_READLINE_HISTORY_STORE) && CONFIG_READLINE_HISTORY_STORE
+    rl->hist.hsave = hsave;
+    rl->hist.hread = hread;
+    rl->hist.lazy = (NULL != hread);
+    rl->hist.saved = 0;
+#endif
+}
+
+/*****************************************************************************
+* @brief        set in place input callbacks, read instead of sget. speek
+*               returns the linear readable region of port ring and its
+*               size, scommit releases size bytes once they are decoded
+*
+* @param[in]    rl          readline instance
+* @param[in]    speek       peek callback, must not consume input
+* @param[in]    scommit     commit callback
+*
+*****************************************************************************/
+void chry_readline_set_peek_cb(chry_readline_t *rl, const uint8_t *(*speek)(chry_readline_t *rl, uint16_t *size), void (*scommit)(chry_readline_t *rl, uint16_t size))
+{
+    (void)rl;
+    (void)speek;
+    (void)scommit;
+#if defined(CONFIG_READLINE_PEEK) && CONFIG_READLINE_PEEK
+    rl->peek.speek = (NULL != scommit) ? speek : NULL;
+    rl->peek.scommit = scommit;
+    rl->peek.pos = 0;
+    rl->peek.len = 0;
+#endif
+}
+
+/*****************************************************************************
+* @brief        set pending input hint callback, must not consume input,
+*               return bytes available (any non-zero value if unknown)
+*
+* @param[in]    rl          readline instance
+* @param[in]    savail      callback
+*
+*****************************************************************************/
+void chry_readline_set_avail_cb(chry_readline_t *rl, uint16_t (*savail)(chry_readline_t *rl))
+{
+    (void)rl;
+    (void)savail;
+#if defined(CONFIG_READLINE_BATCH) && CONFIG_READLINE_BATCH
+    rl->batch.savail = savail;
+#endif
+}
+
 /*****************************************************************************
 * @brief        set ctrl mapping
 *
@@ -2209,6 +4483,25 @@ void chry_readline_debug(chry_readline_t *rl)
 }
 #endif
 
+#if defined(CONFIG_READLINE_PROMPTEDIT) && CONFIG_READLINE_PROMPTEDIT
+/*****************************************************************************
+* @brief        terminate prompt, with SGR reset unless lean mode
+*****************************************************************************/
+static void chry_readline_prompt_end(chry_readline_t *rl, char *end)
+{
+#if defined(CONFIG_READLINE_LEAN) && CONFIG_READLINE_LEAN
+    if (rl->lean) {
+        *end = '\0';
+        return;
+    }
+#else
+    (void)rl;
+#endif
+
+    memcpy(end, "\e[m", 4);
+}
+#endif
+
 /*****************************************************************************
 * @brief        edit the specified segment of the prompt,
 *               segment will be create at first edit
@@ -2227,6 +4520,7 @@ int chry_readline_prompt_edit(chry_readline_t *rl, uint8_t segidx, uint16_t sgrr
     va_list ap;
     char sgrbuf[17];
     uint16_t pptlen;
+    uint16_t tail;
     int freelen;
     int seglen;
     uint16_t segoff = 0;
@@ -2257,73 +4551,45 @@ int chry_readline_prompt_edit(chry_readline_t *rl, uint8_t segidx, uint16_t sgrr
     freelen = rl->ln.pptsize - 1 - 3 - pptlen;
 
     /*!< output sgr sequence and get len */
+#if defined(CONFIG_READLINE_LEAN) && CONFIG_READLINE_LEAN
+    sgrlen = rl->lean ? 0 : chry_readline_sgrset(sgrbuf, sgrraw);
+    rl->drawn = 0;
+#else
     sgrlen = chry_readline_sgrset(sgrbuf, sgrraw);
+#endif
+    rl->pptdirty = 1;
 
     if (freelen < (int)sgrlen) {
         return -2;
     }
 
-    /*!< if next segment is not used */
-    if (rl->pptseglen[segidx + 1] == 0) {
-        /*!< copy sgrbuff to prompt */
-        memcpy(&(rl->prompt[segoff]), sgrbuf, sgrlen);
-        freelen -= sgrlen;
-
-        /*!< output format to prompt */
-        va_start(ap, format);
-        seglen = vsnprintf(&(rl->prompt[segoff + sgrlen]), freelen + 1, format, ap);
-        va_end(ap);
-
-        if (seglen > freelen) {
-            /*!< set segment len */
-            rl->pptseglen[segidx] = sgrlen + freelen;
-
-            /*!< end with \e0m\0 */
-            memcpy(&(rl->prompt[segoff + sgrlen + freelen]), "\e[m", 4);
-            return -2;
-        } else {
-            /*!< set segment len */
-            rl->pptseglen[segidx] = sgrlen + seglen;
-
-            /*!< end with \e0m\0 */
-            memcpy(&(rl->prompt[segoff + sgrlen + seglen]), "\e[m", 4);
-
-            return 0;
-        }
-    }
-
-    /*!< get the seg len */
-    va_start(ap, format);
-    seglen = vsnprintf(NULL, 0, format, ap);
-    va_end(ap);
-
-    int actlen = sgrlen + seglen;
-    actlen = freelen > actlen ? actlen : freelen;
-
+    /*!< park following segments at buffer end, keep a byte for vsnprintf \0 */
+    tail = pptlen - segoff;
     memmove(
-        &(rl->prompt[segoff + actlen]),
+        &(rl->prompt[rl->ln.pptsize - 3 - tail]),
         &(rl->prompt[segoff + rl->pptseglen[segidx]]),
-        pptlen - segoff);
+        tail);
 
     /*!< copy sgrbuff to prompt */
     memcpy(&(rl->prompt[segoff]), sgrbuf, sgrlen);
     freelen -= sgrlen;
 
-    /*!< backup vsnprintf overwrite char */
-    char bakc = rl->prompt[segoff + actlen];
-
-    /*!< output format to prompt */
+    /*!< output format to prompt, only once */
     va_start(ap, format);
     seglen = vsnprintf(&(rl->prompt[segoff + sgrlen]), freelen + 1, format, ap);
     va_end(ap);
 
-    rl->prompt[segoff + actlen] = bakc;
-
     /*!< set segment len */
-    rl->pptseglen[segidx] = actlen;
+    rl->pptseglen[segidx] = sgrlen + (seglen > freelen ? freelen : seglen);
+
+    /*!< join following segments back */
+    memmove(
+        &(rl->prompt[segoff + rl->pptseglen[segidx]]),
+        &(rl->prompt[rl->ln.pptsize - 3 - tail]),
+        tail);
 
     /*!< end with \e0m\0 */
-    memcpy(&(rl->prompt[pptlen + actlen]), "\e[m", 4);
+    chry_readline_prompt_end(rl, &(rl->prompt[pptlen + rl->pptseglen[segidx]]));
 
     if (seglen > freelen) {
         return -2;
@@ -2349,7 +4615,22 @@ void chry_readline_prompt_clear(chry_readline_t *rl)
 {
 #if defined(CONFIG_READLINE_PROMPTEDIT) && CONFIG_READLINE_PROMPTEDIT
     memset(rl->pptseglen, 0, CONFIG_READLINE_PROMPTSEG + 1);
+    rl->pptdirty = 1;
 #else
     (void)rl;
 #endif
 }
+
+/*****************************************************************************
+* @brief        mark prompt changed after writing the prompt buffer directly,
+*               offset and strlen are calculated again on next readline
+*
+* @param[in]    rl          readline instance
+*
+*****************************************************************************/
+void chry_readline_prompt_dirty(chry_readline_t *rl)
+{
+    CHRY_READLINE_PARAM_CHECK(NULL != rl, );
+
+    rl->pptdirty = 1;
+}
@@ -21,6 +21,42 @@ extern "C" {
 #endif
 #endif
 
+#if defined(CONFIG_READLINE_INBUFF) && CONFIG_READLINE_INBUFF
+#if CONFIG_READLINE_INBUFF > 65535
+#error "CONFIG_READLINE_INBUFF cannot be greater than 65535"
+#endif
+#endif
+
+#if defined(CONFIG_READLINE_TXQUEUE) && CONFIG_READLINE_TXQUEUE
+#if (CONFIG_READLINE_TXQUEUE & (CONFIG_READLINE_TXQUEUE - 1)) || (CONFIG_READLINE_TXQUEUE > 32768)
+#error "CONFIG_READLINE_TXQUEUE must be a power of 2 and not greater than 32768"
+#endif
+#endif
+
+#if defined(CONFIG_READLINE_HISTORY) && CONFIG_READLINE_HISTORY
+#if (CONFIG_READLINE_HISTORY_DEPTH & (CONFIG_READLINE_HISTORY_DEPTH - 1)) || (CONFIG_READLINE_HISTORY_DEPTH < 2)
+#error "CONFIG_READLINE_HISTORY_DEPTH must be a power of 2 and not less than 2"
+#endif
+#if defined(CONFIG_READLINE_HISTORY_SEARCH) && (CONFIG_READLINE_HISTORY_SEARCH > 255)
+#error "CONFIG_READLINE_HISTORY_SEARCH must not be greater than 255"
+#endif
+#endif
+
+#if defined(CONFIG_READLINE_TYPEAHEAD) && CONFIG_READLINE_TYPEAHEAD
+#if (CONFIG_READLINE_TYPEAHEAD & (CONFIG_READLINE_TYPEAHEAD - 1)) || (CONFIG_READLINE_TYPEAHEAD > 32768)
+#error "CONFIG_READLINE_TYPEAHEAD must be a power of 2 and not greater than 32768"
+#endif
+#endif
+
+/*!< wait callback timeout, block until input arrives */
+#define CHRY_READLINE_WAIT_FOREVER 0xffffffffUL
+
+/*!< wait callback timeout while transmit queue still holds bytes (ms) */
+#define CHRY_READLINE_WAIT_TXRETRY 1UL
+
+/*!< latency histogram buckets, bucket n counts latency below 16 << 2n */
+#define CHRY_READLINE_STATS_HIST 8
+
 enum {
     CHRY_READLINE_SGR_NONE = 0,
     CHRY_READLINE_SGR_BLACK = 1,
@@ -82,13 +118,116 @@ typedef struct chry_readline {
         uint16_t size;  /*!< histfifo size    */
         uint16_t cache; /*!< history cache    */
         uint16_t index; /*!< history index    */
+        uint16_t iin;   /*!< entry index in   */
+        uint16_t iout;  /*!< entry index out  */
+#if defined(CONFIG_READLINE_HISTORY_PREFIX) && CONFIG_READLINE_HISTORY_PREFIX
+        uint16_t plen;  /*!< browse prefix    */
+#endif
+#if defined(CONFIG_READLINE_HISTORY_STORE) && CONFIG_READLINE_HISTORY_STORE
+        uint8_t lazy;   /*!< store not loaded */
+        uint16_t saved; /*!< saved this boot  */
+
+        void (*hsave)(struct chry_readline *rl, const char *line, uint16_t size);
+        int (*hread)(struct chry_readline *rl, uint32_t *cursor, char *line, uint16_t size);
+#endif
+
+        uint16_t ipos[CONFIG_READLINE_HISTORY_DEPTH];  /*!< entry start pos */
+#if defined(CONFIG_READLINE_HISTORY_DEDUP) && CONFIG_READLINE_HISTORY_DEDUP
+        uint16_t ihash[CONFIG_READLINE_HISTORY_DEPTH]; /*!< entry line hash */
+#endif
     } hist;
+
+#if defined(CONFIG_READLINE_HISTORY_SEARCH) && CONFIG_READLINE_HISTORY_SEARCH
+    struct {
+        uint8_t active;                               /*!< search mode     */
+        uint8_t fail;                                 /*!< no more match   */
+        uint8_t size;                                 /*!< pattern size    */
+        uint16_t origin;                              /*!< index on enter  */
+        char pattern[CONFIG_READLINE_HISTORY_SEARCH]; /*!< search pattern  */
+    } srch;
+#endif
+#endif
+
+#if defined(CONFIG_READLINE_TXQUEUE) && CONFIG_READLINE_TXQUEUE
+    struct {
+        uint16_t in;                           /*!< txqueue in pos  */
+        uint16_t out;                          /*!< txqueue out pos */
+        uint8_t pbuf[CONFIG_READLINE_TXQUEUE]; /*!< txqueue buffer  */
+    } txq;
+#endif
+
+#if defined(CONFIG_READLINE_INBUFF) && CONFIG_READLINE_INBUFF
+    struct {
+        uint16_t pos;                         /*!< inbuff read pos */
+        uint16_t len;                         /*!< inbuff data len */
+        uint8_t pbuf[CONFIG_READLINE_INBUFF]; /*!< inbuff buffer   */
+    } inb;
+#endif
+
+#if defined(CONFIG_READLINE_TYPEAHEAD) && CONFIG_READLINE_TYPEAHEAD
+    struct {
+        uint16_t in;                             /*!< typeahead in pos  */
+        uint16_t out;                            /*!< typeahead out pos */
+        uint8_t pbuf[CONFIG_READLINE_TYPEAHEAD]; /*!< typeahead buffer  */
+    } tah;
+#endif
+
+#if defined(CONFIG_READLINE_PEEK) && CONFIG_READLINE_PEEK
+    struct {
+        const uint8_t *(*speek)(struct chry_readline *rl, uint16_t *size); /*!< readable region  */
+        void (*scommit)(struct chry_readline *rl, uint16_t size);          /*!< release region   */
+        const uint8_t *pdata;                                              /*!< peeked region    */
+        uint16_t pos;                                                      /*!< region read pos  */
+        uint16_t len;                                                      /*!< region data len  */
+    } peek;
+#endif
+
+#if defined(CONFIG_READLINE_PAGER) && CONFIG_READLINE_PAGER
+    struct {
+        uint8_t enable;                        /*!< pager enable          */
+        uint8_t quit;                          /*!< discard output        */
+        uint8_t search;                        /*!< searching pattern     */
+        uint8_t esc;                           /*!< escape sequence state */
+        uint16_t line;                         /*!< lines on this page    */
+        uint16_t col;                          /*!< current column        */
+        uint16_t lnlen;                        /*!< search line length    */
+        uint8_t patlen;                        /*!< search pattern length */
+        char pattern[16];                      /*!< search pattern        */
+        char lnbuf[CONFIG_READLINE_PAGER + 1]; /*!< search line buffer    */
+    } pager;
 #endif
 
     int (*ucb)(struct chry_readline *rl, uint8_t exec);
+    int (*wait)(struct chry_readline *rl, uint32_t timeout);
+
+#if defined(CONFIG_READLINE_ESC_TIMEOUT) && CONFIG_READLINE_ESC_TIMEOUT
+    uint32_t (*clock)(struct chry_readline *rl); /*!< ms tick callback */
+    uint32_t esctick;                            /*!< esc arrive tick */
+#endif
 
     uint8_t ignore;       /*!< only accept */
     uint8_t auto_refresh; /*!< auto refresh */
+    uint8_t pptdirty;     /*!< prompt changed, pptoff and pptlen stale */
+
+#if defined(CONFIG_READLINE_LEAN) && CONFIG_READLINE_LEAN
+    uint8_t lean;  /*!< lean wire, drop sgr */
+    uint8_t drawn; /*!< prompt drawn, no other output since */
+#endif
+
+    struct {
+        uint8_t state;   /*!< decoder state  */
+        uint8_t expre;   /*!< private prefix */
+        uint8_t pnum;    /*!< param index    */
+        uint16_t pns[4]; /*!< number params  */
+    } seq;
+
+#if defined(CONFIG_READLINE_LEAN) && CONFIG_READLINE_LEAN
+    struct {
+        uint8_t state; /*!< sgr filter state  */
+        uint8_t len;   /*!< held sequence len */
+        char hold[14]; /*!< held sequence     */
+    } sgrf;
+#endif
 
 #if defined(CONFIG_READLINE_CTRLMAP) && CONFIG_READLINE_CTRLMAP
     uint8_t ctrlmap[32];
@@ -102,9 +241,51 @@ typedef struct chry_readline {
     uint8_t pptseglen[CONFIG_READLINE_PROMPTSEG + 1];
 #endif
 
+#if defined(CONFIG_READLINE_BATCH) && CONFIG_READLINE_BATCH
+    struct {
+        uint16_t (*savail)(struct chry_readline *rl); /*!< pending input hint */
+        uint8_t defer;                                /*!< refresh may defer */
+        uint8_t dirty;                                /*!< refresh deferred  */
+        uint16_t count;                               /*!< deferred edits    */
+    } batch;
+#endif
+
+#if defined(CONFIG_READLINE_PASTE) && CONFIG_READLINE_PASTE
+    struct {
+        uint8_t enable; /*!< bracketed paste enabled on terminal */
+        uint8_t drop;   /*!< paste started in ignore mode        */
+        uint8_t match;  /*!< end marker bytes matched            */
+        uint16_t tail;  /*!< tail size moved to buffer end       */
+        uint16_t gap;   /*!< tail offset, pasted text limit      */
+        uint16_t pos;   /*!< paste insert offset                 */
+    } paste;
+#endif
+
+#if defined(CONFIG_READLINE_STATS) && CONFIG_READLINE_STATS
+    struct {
+        uint32_t (*stamp)(struct chry_readline *rl); /*!< timestamp callback, us */
+        uint32_t begin;                              /*!< oldest key not echoed  */
+        uint32_t nbyte;                              /*!< echo bytes of this key */
+        uint8_t wait;                                /*!< key waiting for echo   */
+        uint32_t keys;                               /*!< keys received          */
+        uint32_t echoes;                             /*!< echoes measured        */
+        uint32_t bytes;                              /*!< echo bytes measured    */
+        uint32_t min;                                /*!< min latency            */
+        uint32_t max;                                /*!< max latency            */
+        uint64_t sum;                                /*!< total latency          */
+        uint32_t hist[CHRY_READLINE_STATS_HIST];     /*!< latency histogram      */
+    } stats;
+#endif
+
 #if defined(CONFIG_READLINE_NOBLOCK) && CONFIG_READLINE_NOBLOCK
     uint8_t noblock;
     uint8_t block;
+
+    struct {
+        const uint8_t *data; /*!< pushed input, used before sget */
+        uint16_t size;       /*!< pushed input size              */
+        uint16_t pos;        /*!< pushed input read pos          */
+    } feed;
 #endif
 
 } chry_readline_t;
@@ -137,6 +318,9 @@ typedef struct
 extern int chry_readline_init(chry_readline_t *rl, chry_readline_init_t *init);
 extern void chry_readline_debug(chry_readline_t *rl);
 extern char *chry_readline(chry_readline_t *rl, char *linebuff, uint16_t buffsize, uint16_t *linesize);
+#if defined(CONFIG_READLINE_NOBLOCK) && CONFIG_READLINE_NOBLOCK
+extern char *chry_readline_feed(chry_readline_t *rl, char *linebuff, uint16_t buffsize, uint16_t *linesize, const void *data, uint16_t *size);
+#endif
 
 extern int chry_readline_edit_refresh(chry_readline_t *rl);
 extern int chry_readline_edit_clear(chry_readline_t *rl);
@@ -153,6 +337,11 @@ extern int chry_readline_edit_delword(chry_readline_t *rl);
 
 extern int chry_readline_complete(chry_readline_t *rl);
 
+extern uint16_t chry_readline_write(chry_readline_t *rl, const void *data, uint16_t size);
+extern uint16_t chry_readline_poll_tx(chry_readline_t *rl);
+extern void chry_readline_pager(chry_readline_t *rl, uint8_t enable);
+extern uint8_t chry_readline_pager_quit(chry_readline_t *rl);
+
 extern void chry_readline_erase_line(chry_readline_t *rl);
 extern void chry_readline_newline(chry_readline_t *rl);
 extern void chry_readline_detect(chry_readline_t *rl);
@@ -161,15 +350,26 @@ extern void chry_readline_block(chry_readline_t *rl, uint8_t enable);
 extern void chry_readline_ignore(chry_readline_t *rl, uint8_t enable);
 extern void chry_readline_auto_refresh(chry_readline_t *rl, uint8_t enable);
 extern void chry_readline_mask(chry_readline_t *rl, uint8_t enable);
+extern void chry_readline_lean(chry_readline_t *rl, uint8_t enable);
 extern int chry_readline_altscreen(chry_readline_t *rl, uint8_t enable);
 
 extern void chry_readline_set_completion_cb(chry_readline_t *rl, uint8_t (*acb)(chry_readline_t *rl, char *pre, uint16_t *size, const char **argv, uint8_t *argl, uint8_t argcmax));
 extern void chry_readline_set_user_cb(chry_readline_t *rl, int (*ucb)(chry_readline_t *rl, uint8_t exec));
+extern void chry_readline_set_wait_cb(chry_readline_t *rl, int (*wait)(chry_readline_t *rl, uint32_t timeout));
+extern void chry_readline_set_clock_cb(chry_readline_t *rl, uint32_t (*clock)(chry_readline_t *rl));
+extern void chry_readline_set_avail_cb(chry_readline_t *rl, uint16_t (*savail)(chry_readline_t *rl));
+extern void chry_readline_set_stamp_cb(chry_readline_t *rl, uint32_t (*stamp)(chry_readline_t *rl));
+extern void chry_readline_stats_reset(chry_readline_t *rl);
+extern void chry_readline_set_histstore_cb(chry_readline_t *rl,
+                                           void (*hsave)(chry_readline_t *rl, const char *line, uint16_t size),
+                                           int (*hread)(chry_readline_t *rl, uint32_t *cursor, char *line, uint16_t size));
+extern void chry_readline_set_peek_cb(chry_readline_t *rl, const uint8_t *(*speek)(chry_readline_t *rl, uint16_t *size), void (*scommit)(chry_readline_t *rl, uint16_t size));
 extern void chry_readline_set_ctrlmap(chry_readline_t *rl, uint8_t mapidx, uint8_t exec);
 extern void chry_readline_set_altmap(chry_readline_t *rl, uint8_t mapidx, uint8_t exec);
 
 extern int chry_readline_prompt_edit(chry_readline_t *rl, uint8_t segidx, uint16_t sgrraw, const char *format, ...);
 extern void chry_readline_prompt_clear(chry_readline_t *rl);
+extern void chry_readline_prompt_dirty(chry_readline_t *rl);
 
 #ifdef __cplusplus
 }
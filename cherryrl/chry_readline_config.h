@@ -31,6 +31,41 @@
 #define CONFIG_READLINE_HISTORY 1
 #endif
 
+/*!< max history entries, indexed by offset (use 2 x depth byte), must be power of 2 */
+#ifndef CONFIG_READLINE_HISTORY_DEPTH
+#define CONFIG_READLINE_HISTORY_DEPTH 32
+#endif
+
+/*!< history duplicate check, 0:off 1:skip same as last 2:also erase older copies */
+#ifndef CONFIG_READLINE_HISTORY_DEDUP
+#define CONFIG_READLINE_HISTORY_DEDUP 1
+#endif
+
+/*!< reverse history search on ctrl-r, max pattern length, 0:off */
+#ifndef CONFIG_READLINE_HISTORY_SEARCH
+#define CONFIG_READLINE_HISTORY_SEARCH 0
+#endif
+
+/*!< up and down only visit history starting with text before cursor */
+#ifndef CONFIG_READLINE_HISTORY_PREFIX
+#define CONFIG_READLINE_HISTORY_PREFIX 0
+#endif
+
+/*!< history storage callbacks, stored history is loaded on first browse */
+#ifndef CONFIG_READLINE_HISTORY_STORE
+#define CONFIG_READLINE_HISTORY_STORE 0
+#endif
+
+/*!< history prefix compression, entries store only the suffix after prefix shared with the older one */
+#ifndef CONFIG_READLINE_HISTORY_PACK
+#define CONFIG_READLINE_HISTORY_PACK 0
+#endif
+
+/*!< history expansion at line start, !! !-n and !prefix */
+#ifndef CONFIG_READLINE_HISTORY_EXPAND
+#define CONFIG_READLINE_HISTORY_EXPAND 0
+#endif
+
 /*!< completion support <+800byte> */
 #ifndef CONFIG_READLINE_COMPLETION
 #define CONFIG_READLINE_COMPLETION 1
@@ -86,6 +121,56 @@
 #define CONFIG_READLINE_NOBLOCK 0
 #endif
 
+/*!< transmit queue size, must be a power of 2, 0 to disable */
+#ifndef CONFIG_READLINE_TXQUEUE
+#define CONFIG_READLINE_TXQUEUE 0
+#endif
+
+/*!< bracketed paste, pasted text is inserted with one refresh */
+#ifndef CONFIG_READLINE_PASTE
+#define CONFIG_READLINE_PASTE 0
+#endif
+
+/*!< max edits applied per refresh while input is pending, 0 to disable */
+#ifndef CONFIG_READLINE_BATCH
+#define CONFIG_READLINE_BATCH 0
+#endif
+
+/*!< lone esc timeout in ms, needs clock callback, 0 to disable */
+#ifndef CONFIG_READLINE_ESC_TIMEOUT
+#define CONFIG_READLINE_ESC_TIMEOUT 0
+#endif
+
+/*!< lean wire mode, SGR can be dropped from output at runtime */
+#ifndef CONFIG_READLINE_LEAN
+#define CONFIG_READLINE_LEAN 0
+#endif
+
+/*!< input buffer size, refilled by one sget call, 0 to disable */
+#ifndef CONFIG_READLINE_INBUFF
+#define CONFIG_READLINE_INBUFF 0
+#endif
+
+/*!< read input in place from port ring by peek and commit callbacks */
+#ifndef CONFIG_READLINE_PEEK
+#define CONFIG_READLINE_PEEK 0
+#endif
+
+/*!< key to echo latency and echo bytes statistics, needs stamp callback */
+#ifndef CONFIG_READLINE_STATS
+#define CONFIG_READLINE_STATS 0
+#endif
+
+/*!< typeahead queue size kept in ignore mode, must be power of 2, 0 to disable */
+#ifndef CONFIG_READLINE_TYPEAHEAD
+#define CONFIG_READLINE_TYPEAHEAD 0
+#endif
+
+/*!< pager for command output, search line buffer size, 0 to disable */
+#ifndef CONFIG_READLINE_PAGER
+#define CONFIG_READLINE_PAGER 0
+#endif
+
 /*!< help information */
 #ifndef CONFIG_READLINE_HELP
 #define CONFIG_READLINE_HELP ""
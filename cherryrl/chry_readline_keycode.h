@@ -326,6 +326,7 @@ enum {
     CHRY_READLINE_EXEC_F11,       /*!< Fucntion 11               */
     CHRY_READLINE_EXEC_F12,       /*!< Fucntion 12               */
     CHRY_READLINE_EXEC_USER,      /*!< User Event Start          */
+    CHRY_READLINE_EXEC_SRCH = 254, /*!< Reverse search history   */
     CHRY_READLINE_EXEC_END = 255, /*!< Max Value is 255          */
 };
 
@@ -347,7 +348,7 @@ enum {
     CHRY_READLINE_CTRLMAP_O,     /*!< default is NLN    */
     CHRY_READLINE_CTRLMAP_P,     /*!< default is PRVH   */
     CHRY_READLINE_CTRLMAP_Q,     /*!< default is NUL    */
-    CHRY_READLINE_CTRLMAP_R,     /*!< default is NUL    */
+    CHRY_READLINE_CTRLMAP_R,     /*!< default is SRCH   */
     CHRY_READLINE_CTRLMAP_S,     /*!< default is NUL    */
     CHRY_READLINE_CTRLMAP_T,     /*!< default is NUL    */
     CHRY_READLINE_CTRLMAP_U,     /*!< default is DHLN   */
@@ -356,6 +357,7 @@ enum {
     CHRY_READLINE_CTRLMAP_X,     /*!< default is NUL    */
     CHRY_READLINE_CTRLMAP_Y,     /*!< default is NUL    */
     CHRY_READLINE_CTRLMAP_Z,     /*!< default is ALN    */
+    CHRY_READLINE_CTRLMAP_ESC,   /*!< default is NUL    */
 };
 
 enum {
@@ -6,6 +6,10 @@
 #include <termios.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <poll.h>
+#include <time.h>
 #include <assert.h>
 
 #include "chry_readline.h"
@@ -77,16 +81,107 @@ static uint16_t sput(chry_readline_t *rl, const void *data, uint16_t size)
 
 static uint16_t sget(chry_readline_t *rl, void *data, uint16_t size)
 {
-    uint16_t i;
+    ssize_t n;
     (void)rl;
-    for (i = 0; i < size; i++) {
-        if (1 != read(STDIN_FILENO, (uint8_t *)data + i, 1)) {
-            break;
+
+    /*!< stdin is nonblock, read all available bytes with one syscall */
+    n = read(STDIN_FILENO, data, size);
+
+    return n > 0 ? n : 0;
+}
+
+static uint16_t savail(chry_readline_t *rl)
+{
+    int n;
+    (void)rl;
+
+    /*!< bytes waiting in tty input queue, not consumed */
+    if (ioctl(STDIN_FILENO, FIONREAD, &n) < 0) {
+        return 0;
+    }
+
+    return n > 0xffff ? 0xffff : n;
+}
+
+static int wait_input(chry_readline_t *rl, uint32_t timeout)
+{
+    struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN };
+    (void)rl;
+
+    /*!< sleep until stdin is readable instead of spinning on read */
+    if (poll(&pfd, 1, timeout == CHRY_READLINE_WAIT_FOREVER ? -1 : (int)timeout) > 0) {
+        return 0;
+    }
+
+    return 1;
+}
+
+static uint32_t clock_ms(chry_readline_t *rl)
+{
+    struct timespec ts;
+    (void)rl;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static uint32_t stamp_us(chry_readline_t *rl)
+{
+    struct timespec ts;
+    (void)rl;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+
+#if defined(CONFIG_READLINE_HISTORY_STORE) && CONFIG_READLINE_HISTORY_STORE
+static int histfd = -1;
+
+/*!< append only log, each record is line, size in 2byte little endian and '\n' */
+static void hist_save(chry_readline_t *rl, const char *line, uint16_t size)
+{
+    uint8_t tail[3] = { size & 0xff, size >> 8, '\n' };
+    struct iovec iov[2] = { { (void *)line, size }, { tail, sizeof(tail) } };
+    (void)rl;
+
+    /*!< one write per record, a torn record ends the log on read */
+    if (histfd >= 0) {
+        if (writev(histfd, iov, 2) != (ssize_t)(size + sizeof(tail))) {
+            close(histfd);
+            histfd = -1;
         }
     }
+}
 
-    return i;
+/*!< read records backward from end of file, cursor is bytes already read */
+static int hist_read(chry_readline_t *rl, uint32_t *cursor, char *line, uint16_t size)
+{
+    uint8_t tail[3];
+    uint16_t lnsize;
+    off_t end;
+    (void)rl;
+
+    if (histfd < 0) {
+        return -1;
+    }
+
+    end = lseek(histfd, 0, SEEK_END) - *cursor;
+    if ((end < (off_t)sizeof(tail)) || (pread(histfd, tail, sizeof(tail), end - sizeof(tail)) != sizeof(tail)) || (tail[2] != '\n')) {
+        return -1;
+    }
+
+    lnsize = tail[0] | (tail[1] << 8);
+    end -= sizeof(tail) + lnsize;
+    if (end < 0) {
+        return -1;
+    }
+
+    *cursor += lnsize + sizeof(tail);
+    lnsize = lnsize > size ? size : lnsize;
+
+    return pread(histfd, line, lnsize, end) == lnsize ? lnsize : -1;
 }
+#endif
 
 chry_readline_t rl;
 
@@ -251,11 +346,23 @@ int main(int argc, char **argv)
 
     chry_readline_set_completion_cb(&rl, acb);
     chry_readline_set_user_cb(&rl, ucb);
+    chry_readline_set_avail_cb(&rl, savail);
+    chry_readline_set_wait_cb(&rl, wait_input);
+    chry_readline_set_clock_cb(&rl, clock_ms);
+    chry_readline_set_stamp_cb(&rl, stamp_us);
+
+#if defined(CONFIG_READLINE_HISTORY_STORE) && CONFIG_READLINE_HISTORY_STORE
+    /*!< history kept across runs, loaded on first up arrow */
+    histfd = open(".chry_history", O_RDWR | O_CREAT | O_APPEND, 0644);
+    chry_readline_set_histstore_cb(&rl, hist_save, hist_read);
+#endif
 
     /*!< mapping ctrl+q to exec user event 1 */
     chry_readline_set_ctrlmap(&rl, CHRY_READLINE_CTRLMAP_X, CHRY_READLINE_EXEC_USER);
     /*!< mapping alt+q to exec user event 2 */
     chry_readline_set_altmap(&rl, CHRY_READLINE_ALTMAP_X, CHRY_READLINE_EXEC_USER + 1);
+    /*!< mapping lone esc to exec user event 3, needs CONFIG_READLINE_ESC_TIMEOUT */
+    chry_readline_set_ctrlmap(&rl, CHRY_READLINE_CTRLMAP_ESC, CHRY_READLINE_EXEC_USER + 2);
 
     if (repl) {
         goto repl;
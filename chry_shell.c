@@ -370,6 +370,31 @@ static int chry_shell_user_callback(chry_readline_t *rl, uint8_t exec)
 }
 #endif
 
+/*****************************************************************************
+* @brief        build all prompt segments
+*
+* @param[in]    csh         shell instance
+*
+* @retval                   0:Success <0:Error
+*****************************************************************************/
+static int chry_shell_prompt_build(chry_shell_t *csh)
+{
+    int ret = 0;
+
+#if defined(CONFIG_CSH_PROMPTEDIT) && CONFIG_CSH_PROMPTEDIT
+    ret |= chry_readline_prompt_edit(&csh->rl, CSH_PROMPT_SEG_USER, (chry_readline_sgr_t){ .foreground = CHRY_READLINE_SGR_GREEN, .bold = 1 }.raw, csh->user[csh->uid]);
+    ret |= chry_readline_prompt_edit(&csh->rl, CSH_PROMPT_SEG_USER + 1, (chry_readline_sgr_t){ .foreground = CHRY_READLINE_SGR_GREEN, .bold = 1 }.raw, "@");
+    ret |= chry_readline_prompt_edit(&csh->rl, CSH_PROMPT_SEG_HOST, (chry_readline_sgr_t){ .foreground = CHRY_READLINE_SGR_GREEN, .bold = 1 }.raw, csh->host);
+    ret |= chry_readline_prompt_edit(&csh->rl, CSH_PROMPT_SEG_HOST + 1, 0, ":");
+    ret |= chry_readline_prompt_edit(&csh->rl, CSH_PROMPT_SEG_PATH, (chry_readline_sgr_t){ .foreground = CHRY_READLINE_SGR_BLUE, .bold = 1 }.raw, csh->path);
+    ret |= chry_readline_prompt_edit(&csh->rl, CSH_PROMPT_SEG_PATH + 1, 0, "$ ");
+#else
+    (void)csh;
+#endif
+
+    return ret;
+}
+
 /*****************************************************************************
 * @brief        init shell
 *
@@ -474,16 +499,8 @@ int chry_shell_init(chry_shell_t *csh, const chry_shell_init_t *init)
     chry_readline_set_user_cb(&csh->rl, chry_shell_user_callback);
 #endif
 
-#if defined(CONFIG_CSH_PROMPTEDIT) && CONFIG_CSH_PROMPTEDIT
-    ret |= chry_readline_prompt_edit(&csh->rl, CSH_PROMPT_SEG_USER, (chry_readline_sgr_t){ .foreground = CHRY_READLINE_SGR_GREEN, .bold = 1 }.raw, csh->user[csh->uid]);
-    ret |= chry_readline_prompt_edit(&csh->rl, CSH_PROMPT_SEG_USER + 1, (chry_readline_sgr_t){ .foreground = CHRY_READLINE_SGR_GREEN, .bold = 1 }.raw, "@");
-    ret |= chry_readline_prompt_edit(&csh->rl, CSH_PROMPT_SEG_HOST, (chry_readline_sgr_t){ .foreground = CHRY_READLINE_SGR_GREEN, .bold = 1 }.raw, csh->host);
-    ret |= chry_readline_prompt_edit(&csh->rl, CSH_PROMPT_SEG_HOST + 1, 0, ":");
-    ret |= chry_readline_prompt_edit(&csh->rl, CSH_PROMPT_SEG_PATH, (chry_readline_sgr_t){ .foreground = CHRY_READLINE_SGR_BLUE, .bold = 1 }.raw, csh->path);
-    ret |= chry_readline_prompt_edit(&csh->rl, CSH_PROMPT_SEG_PATH + 1, 0, "$ ");
-#else
+    ret |= chry_shell_prompt_build(csh);
 
-#endif
     return ret;
 }
 
@@ -526,38 +543,21 @@ void chry_shell_task_exec(chry_shell_t *csh)
 }
 
 /*****************************************************************************
-* @brief        read eval print loop task
+* @brief        evaluate line returned by readline
 *
 * @param[in]    csh         shell instance
+* @param[in]    line        readline return
+* @param[in]    linesize    line size
 *
 * @retval                   0:Success -1:Error 1:Continue
 *****************************************************************************/
-int chry_shell_task_repl(chry_shell_t *csh)
+static int chry_shell_task_eval(chry_shell_t *csh, char *line, uint16_t *linesize)
 {
-    CHRY_SHELL_PARAM_CHECK(NULL != csh, -1);
-    char *csh_linebuff;
-    uint16_t *csh_linesize;
-
-#if defined(CONFIG_CSH_LNBUFF_STATIC) && CONFIG_CSH_LNBUFF_STATIC
-    csh_linebuff = csh->linebuff;
-    csh_linesize = &csh->linesize;
-
-    char *line = chry_readline(&csh->rl, csh_linebuff, csh->buffsize, csh_linesize);
-#else
-    char linebuff[CONFIG_CSH_LNBUFF_SIZE];
-    uint16_t linesize;
-
-    csh_linebuff = linebuff;
-    csh_linesize = &linesize;
-
-    char *line = chry_readline(&csh->rl, csh_linebuff, CONFIG_CSH_LNBUFF_SIZE, csh_linesize);
-#endif
-
     if (line == NULL) {
         return -1;
     } else if (line == (void *)-1) {
         return 1;
-    } else if (*csh_linesize) {
+    } else if (*linesize) {
         int *argc;
         const char **argv;
         volatile uint8_t *pexec = (void *)&csh->exec;
@@ -574,7 +574,7 @@ int chry_shell_task_repl(chry_shell_t *csh)
         argv = &csh_exec_argv[0];
 #endif
 
-        *argc = chry_shell_parse(line, *csh_linesize, argv, CONFIG_CSH_MAX_ARG + 1);
+        *argc = chry_shell_parse(line, *linesize, argv, CONFIG_CSH_MAX_ARG + 1);
 
         /*!< compile environment variable */
         for (uint8_t i = 0; i < *argc;) {
@@ -682,9 +682,9 @@ int chry_shell_task_repl(chry_shell_t *csh)
             if (NULL == argv[*argc + 2]) {
                 *pexec = CSH_STATUS_EXEC_IDLE;
 
-                csh->rl.sput(&csh->rl, argv[0], strlen(argv[0]));
-                csh->rl.sput(&csh->rl, ": command not found" CONFIG_CSH_NEWLINE CONFIG_CSH_NEWLINE,
-                             19 + (sizeof(CONFIG_CSH_NEWLINE) ? (sizeof(CONFIG_CSH_NEWLINE) - 1) * 2 : 0));
+                chry_readline_write(&csh->rl, argv[0], strlen(argv[0]));
+                chry_readline_write(&csh->rl, ": command not found" CONFIG_CSH_NEWLINE CONFIG_CSH_NEWLINE,
+                                    19 + (sizeof(CONFIG_CSH_NEWLINE) ? (sizeof(CONFIG_CSH_NEWLINE) - 1) * 2 : 0));
             } else {
 #if defined(CONFIG_CSH_MULTI_THREAD) && CONFIG_CSH_MULTI_THREAD
                 *pexec = CSH_STATUS_EXEC_FIND;
@@ -705,13 +705,15 @@ int chry_shell_task_repl(chry_shell_t *csh)
                 if (0 != chry_shell_port_create_context(csh, *argc, argv)) {
                     *pexec = CSH_STATUS_EXEC_IDLE;
 
-                    csh->rl.sput(&csh->rl, argv[0], strlen(argv[0]));
-                    csh->rl.sput(&csh->rl, ": context creation error" CONFIG_CSH_NEWLINE CONFIG_CSH_NEWLINE,
-                                 24 + (sizeof(CONFIG_CSH_NEWLINE) ? (sizeof(CONFIG_CSH_NEWLINE) - 1) * 2 : 0));
+                    chry_readline_write(&csh->rl, argv[0], strlen(argv[0]));
+                    chry_readline_write(&csh->rl, ": context creation error" CONFIG_CSH_NEWLINE CONFIG_CSH_NEWLINE,
+                                        24 + (sizeof(CONFIG_CSH_NEWLINE) ? (sizeof(CONFIG_CSH_NEWLINE) - 1) * 2 : 0));
                 }
 #else
                 *pexec = CSH_STATUS_EXEC_FIND;
+                chry_readline_pager(&csh->rl, true);
                 chry_shell_task_exec_internal(csh, *argc, argv);
+                chry_readline_pager(&csh->rl, false);
                 *pexec = CSH_STATUS_EXEC_IDLE;
 #endif
             }
@@ -723,6 +725,72 @@ int chry_shell_task_repl(chry_shell_t *csh)
     return 0;
 }
 
+/*****************************************************************************
+* @brief        read eval print loop task
+*
+* @param[in]    csh         shell instance
+*
+* @retval                   0:Success -1:Error 1:Continue
+*****************************************************************************/
+int chry_shell_task_repl(chry_shell_t *csh)
+{
+    CHRY_SHELL_PARAM_CHECK(NULL != csh, -1);
+    char *csh_linebuff;
+    uint16_t *csh_linesize;
+
+#if defined(CONFIG_CSH_LNBUFF_STATIC) && CONFIG_CSH_LNBUFF_STATIC
+    csh_linebuff = csh->linebuff;
+    csh_linesize = &csh->linesize;
+
+    char *line = chry_readline(&csh->rl, csh_linebuff, csh->buffsize, csh_linesize);
+#else
+    char linebuff[CONFIG_CSH_LNBUFF_SIZE];
+    uint16_t linesize;
+
+    csh_linebuff = linebuff;
+    csh_linesize = &linesize;
+
+    char *line = chry_readline(&csh->rl, csh_linebuff, CONFIG_CSH_LNBUFF_SIZE, csh_linesize);
+#endif
+
+    return chry_shell_task_eval(csh, line, csh_linesize);
+}
+
+#if defined(CONFIG_CSH_NOBLOCK) && CONFIG_CSH_NOBLOCK
+/*****************************************************************************
+* @brief        read eval print loop on pushed input, for uart isr, usb or
+*               socket receive without sget ringbuffer.
+*               commands are executed in the caller context
+*
+* @param[in]    csh         shell instance
+* @param[in]    data        input bytes
+* @param[in]    size        input size
+*
+* @retval                   0:Success -1:Error 1:Continue
+*****************************************************************************/
+int chry_shell_task_feed(chry_shell_t *csh, const void *data, uint16_t size)
+{
+    CHRY_SHELL_PARAM_CHECK(NULL != csh, -1);
+    CHRY_SHELL_PARAM_CHECK(NULL != data, -1);
+    const uint8_t *pdata = data;
+    uint16_t used;
+    char *line;
+    int ret;
+
+    do {
+        used = size;
+        line = chry_readline_feed(&csh->rl, csh->linebuff, csh->buffsize, &csh->linesize, pdata, &used);
+        ret = chry_shell_task_eval(csh, line, &csh->linesize);
+
+        /*!< feed rest after a completed line, then redraw prompt */
+        pdata += used;
+        size -= used;
+    } while (ret == 0);
+
+    return ret;
+}
+#endif
+
 /*****************************************************************************
 * @brief        parse line to argc,argv[]
 *
@@ -981,6 +1049,31 @@ void chry_shell_get_path(chry_shell_t *csh, uint8_t size, char *path)
     path[size - 1] = '\0';
 }
 
+/*****************************************************************************
+* @brief        enable or disable lean wire mode, drops SGR colors from
+*               prompt and command output
+*
+* @param[in]    csh         shell instance
+* @param[in]    enable      lean enable
+*
+* @retval                   0:Success <0:Error
+*****************************************************************************/
+int chry_shell_set_lean(chry_shell_t *csh, uint8_t enable)
+{
+    CHRY_SHELL_PARAM_CHECK(NULL != csh, -1);
+
+#if defined(CONFIG_CSH_LEAN) && CONFIG_CSH_LEAN
+    chry_readline_lean(&csh->rl, enable);
+
+    /*!< rebuild prompt with or without colors */
+    return chry_shell_prompt_build(csh);
+#else
+    (void)csh;
+    (void)enable;
+    return -1;
+#endif
+}
+
 /*****************************************************************************
 * @brief        substitute user
 *
@@ -1047,13 +1140,181 @@ int csh_printf(chry_shell_t *csh, const char *fmt, ...)
     char shell_printf_buffer[CONFIG_CSH_PRINT_BUFFER_SIZE];
     va_list args;
 
+    if (chry_readline_pager_quit(&csh->rl)) {
+        /*!< output discarded by pager, skip formatting */
+        return 0;
+    }
+
     va_start(args, fmt);
     n = vsnprintf(shell_printf_buffer, sizeof(shell_printf_buffer), fmt, args);
     if (n > (int)sizeof(shell_printf_buffer)) {
-        csh->rl.sput(&csh->rl, shell_printf_buffer, sizeof(shell_printf_buffer));
+        chry_readline_write(&csh->rl, shell_printf_buffer, sizeof(shell_printf_buffer));
     } else if (n > 0) {
-        csh->rl.sput(&csh->rl, shell_printf_buffer, n);
+        chry_readline_write(&csh->rl, shell_printf_buffer, n);
     }
     va_end(args);
     return n;
 }
+
+/*****************************************************************************
+* @brief        init row writer, rows are batched and sent by whole buffers
+*
+* @param[in]    row         row writer
+* @param[in]    csh         shell instance
+*
+*****************************************************************************/
+void csh_row_init(csh_row_t *row, chry_shell_t *csh)
+{
+    row->csh = csh;
+    row->size = 0;
+}
+
+/*****************************************************************************
+* @brief        send all buffered data
+*
+* @param[in]    row         row writer
+*
+*****************************************************************************/
+void csh_row_flush(csh_row_t *row)
+{
+    if (chry_readline_pager_quit(&row->csh->rl)) {
+        row->size = 0;
+    } else if (row->size) {
+        chry_readline_write(&row->csh->rl, row->buff, row->size);
+        row->size = 0;
+    }
+}
+
+/*****************************************************************************
+* @brief        append repeated char to row
+*
+* @param[in]    row         row writer
+* @param[in]    c           fill char
+* @param[in]    count       fill count
+*
+*****************************************************************************/
+void csh_row_fill(csh_row_t *row, char c, uint16_t count)
+{
+    while (count) {
+        uint16_t n = sizeof(row->buff) - row->size;
+
+        if (n == 0) {
+            csh_row_flush(row);
+            continue;
+        }
+
+        n = count < n ? count : n;
+        memset(&row->buff[row->size], c, n);
+        row->size += n;
+        count -= n;
+    }
+}
+
+/*****************************************************************************
+* @brief        append raw data to row
+*
+* @param[in]    row         row writer
+* @param[in]    data        data pointer
+* @param[in]    size        data size
+*
+*****************************************************************************/
+void csh_row_write(csh_row_t *row, const void *data, uint16_t size)
+{
+    const char *p = data;
+
+    while (size) {
+        uint16_t n = sizeof(row->buff) - row->size;
+
+        if (n == 0) {
+            csh_row_flush(row);
+            continue;
+        }
+
+        n = size < n ? size : n;
+        memcpy(&row->buff[row->size], p, n);
+        row->size += n;
+        p += n;
+        size -= n;
+    }
+}
+
+/*****************************************************************************
+* @brief        append string cell, padded with space to width
+*
+* @param[in]    row         row writer
+* @param[in]    sgr         sgr sequence (eg. "\e[32m"), NULL for plain text
+* @param[in]    str         cell string
+* @param[in]    width       cell width, padding excludes sgr sequence
+*
+*****************************************************************************/
+void csh_row_cell(csh_row_t *row, const char *sgr, const char *str, uint16_t width)
+{
+    uint16_t len = strlen(str);
+
+    if (sgr) {
+        csh_row_write(row, sgr, strlen(sgr));
+        csh_row_write(row, str, len);
+        csh_row_write(row, "\e[m", 3);
+    } else {
+        csh_row_write(row, str, len);
+    }
+
+    if (len < width) {
+        csh_row_fill(row, ' ', width - len);
+    }
+}
+
+/*****************************************************************************
+* @brief        append formatted string to row
+*
+* @param[in]    row         row writer
+* @param[in]    fmt         string format
+*
+* @retval                   formatted size
+* @note                     output is truncated to the row buffer size
+*****************************************************************************/
+int csh_row_printf(csh_row_t *row, const char *fmt, ...)
+{
+    int n;
+    uint16_t space;
+    va_list args;
+
+    if (chry_readline_pager_quit(&row->csh->rl)) {
+        /*!< output discarded by pager, skip formatting */
+        return 0;
+    }
+
+    space = sizeof(row->buff) - row->size;
+
+    va_start(args, fmt);
+    n = vsnprintf(&row->buff[row->size], space, fmt, args);
+    va_end(args);
+
+    if (n < 0) {
+        return n;
+    }
+
+    if (n >= space && row->size) {
+        /*!< not fit, flush and format again into the whole buffer */
+        csh_row_flush(row);
+        space = sizeof(row->buff);
+
+        va_start(args, fmt);
+        n = vsnprintf(row->buff, space, fmt, args);
+        va_end(args);
+    }
+
+    row->size += n < space ? n : space - 1;
+    return n;
+}
+
+/*****************************************************************************
+* @brief        end current row with newline
+*
+* @param[in]    row         row writer
+*
+*****************************************************************************/
+void csh_row_end(csh_row_t *row)
+{
+    csh_row_write(row, CONFIG_CSH_NEWLINE, sizeof(CONFIG_CSH_NEWLINE) - 1);
+}
@@ -30,6 +30,18 @@ extern "C" {
 #endif
 #endif
 
+/*!< check multi-thread and pager */
+#if (defined(CONFIG_CSH_MULTI_THREAD) && CONFIG_CSH_MULTI_THREAD) && \
+    (defined(CONFIG_CSH_PAGER) && CONFIG_CSH_PAGER)
+#error "CONFIG_CSH_PAGER and CONFIG_CSH_MULTI_THREAD cannot be enabled at the same time."
+#endif
+
+/*!< check multi-thread and transmit queue */
+#if (defined(CONFIG_CSH_MULTI_THREAD) && CONFIG_CSH_MULTI_THREAD) && \
+    (defined(CONFIG_CSH_TXQUEUE) && CONFIG_CSH_TXQUEUE)
+#error "CONFIG_CSH_TXQUEUE and CONFIG_CSH_MULTI_THREAD cannot be enabled at the same time."
+#endif
+
 #if ((defined(CONFIG_CSH_NOBLOCK) && CONFIG_CSH_NOBLOCK) && \
      (!defined(CONFIG_CSH_LNBUFF_STATIC) || (CONFIG_CSH_LNBUFF_STATIC == 0)))
 #error "CONFIG_CSH_LNBUFF_STATIC and CONFIG_CSH_NOBLOCK must be enabled at the same time."
@@ -138,6 +150,12 @@ typedef struct {
 
 typedef void (*chry_sighandler_t)(chry_shell_t *csh, int signum);
 
+typedef struct {
+    chry_shell_t *csh;                       /*!< shell instance */
+    uint16_t size;                           /*!< buffered size  */
+    char buff[CONFIG_CSH_PRINT_BUFFER_SIZE]; /*!< row buffer     */
+} csh_row_t;
+
 typedef struct {
     /*!< I/O section */
     uint16_t (*sput)(chry_readline_t *rl, const void *, uint16_t); /*!< output callback */
@@ -175,6 +193,9 @@ typedef struct {
 
 int chry_shell_init(chry_shell_t *csh, const chry_shell_init_t *init);
 int chry_shell_task_repl(chry_shell_t *csh);
+#if defined(CONFIG_CSH_NOBLOCK) && CONFIG_CSH_NOBLOCK
+int chry_shell_task_feed(chry_shell_t *csh, const void *data, uint16_t size);
+#endif
 void chry_shell_task_exec(chry_shell_t *csh);
 
 int chry_shell_parse(char *line, uint32_t linesize, const char **argv, uint8_t argcmax);
@@ -184,6 +205,7 @@ int chry_shell_set_host(chry_shell_t *csh, const char *host);
 int chry_shell_set_user(chry_shell_t *csh, uint8_t uid, const char *user, const char *hash);
 int chry_shell_set_path(chry_shell_t *csh, uint8_t size, const char *path);
 void chry_shell_get_path(chry_shell_t *csh, uint8_t size, char *path);
+int chry_shell_set_lean(chry_shell_t *csh, uint8_t enable);
 int chry_shell_substitute_user(chry_shell_t *csh, uint8_t uid, const char *password);
 
 char *chry_shell_getenv(chry_shell_t *csh, const char *name);
@@ -196,6 +218,14 @@ int chry_shell_execvp(chry_shell_t *csh, const char *__file, char *const __argv[
 
 int csh_printf(chry_shell_t *csh, const char *fmt, ...);
 
+void csh_row_init(csh_row_t *row, chry_shell_t *csh);
+void csh_row_fill(csh_row_t *row, char c, uint16_t count);
+void csh_row_write(csh_row_t *row, const void *data, uint16_t size);
+void csh_row_cell(csh_row_t *row, const char *sgr, const char *str, uint16_t width);
+int csh_row_printf(csh_row_t *row, const char *fmt, ...);
+void csh_row_end(csh_row_t *row);
+void csh_row_flush(csh_row_t *row);
+
 int csh_login(chry_shell_t *csh);
 
 #ifdef __cplusplus
@@ -40,6 +40,41 @@
 #define CONFIG_CSH_HISTORY 1
 #endif
 
+/*!< max history entries, indexed by offset (use 2 x depth byte), must be power of 2 */
+#ifndef CONFIG_CSH_HISTORY_DEPTH
+#define CONFIG_CSH_HISTORY_DEPTH 32
+#endif
+
+/*!< history duplicate check, 0:off 1:skip same as last 2:also erase older copies */
+#ifndef CONFIG_CSH_HISTORY_DEDUP
+#define CONFIG_CSH_HISTORY_DEDUP 1
+#endif
+
+/*!< reverse history search on ctrl-r, max pattern length, 0:off */
+#ifndef CONFIG_CSH_HISTORY_SEARCH
+#define CONFIG_CSH_HISTORY_SEARCH 0
+#endif
+
+/*!< up and down only visit history starting with text before cursor */
+#ifndef CONFIG_CSH_HISTORY_PREFIX
+#define CONFIG_CSH_HISTORY_PREFIX 0
+#endif
+
+/*!< history storage callbacks, stored history is loaded on first browse */
+#ifndef CONFIG_CSH_HISTORY_STORE
+#define CONFIG_CSH_HISTORY_STORE 0
+#endif
+
+/*!< history prefix compression, entries store only the suffix after prefix shared with the older one */
+#ifndef CONFIG_CSH_HISTORY_PACK
+#define CONFIG_CSH_HISTORY_PACK 0
+#endif
+
+/*!< history expansion at line start, !! !-n and !prefix */
+#ifndef CONFIG_CSH_HISTORY_EXPAND
+#define CONFIG_CSH_HISTORY_EXPAND 0
+#endif
+
 /*!< completion support <+1100byte> */
 #ifndef CONFIG_CSH_COMPLETION
 #define CONFIG_CSH_COMPLETION 1
@@ -95,6 +130,56 @@
 #define CONFIG_CSH_NOBLOCK 0
 #endif
 
+/*!< transmit queue size, must be a power of 2, 0 to disable, not with multi-thread */
+#ifndef CONFIG_CSH_TXQUEUE
+#define CONFIG_CSH_TXQUEUE 0
+#endif
+
+/*!< bracketed paste, pasted text is inserted with one refresh */
+#ifndef CONFIG_CSH_PASTE
+#define CONFIG_CSH_PASTE 0
+#endif
+
+/*!< max edits applied per refresh while input is pending, 0 to disable */
+#ifndef CONFIG_CSH_BATCH
+#define CONFIG_CSH_BATCH 0
+#endif
+
+/*!< lone esc timeout in ms, needs clock callback, 0 to disable */
+#ifndef CONFIG_CSH_ESC_TIMEOUT
+#define CONFIG_CSH_ESC_TIMEOUT 0
+#endif
+
+/*!< lean wire mode, SGR can be dropped from output at runtime */
+#ifndef CONFIG_CSH_LEAN
+#define CONFIG_CSH_LEAN 0
+#endif
+
+/*!< input buffer size, refilled by one sget call, 0 to disable */
+#ifndef CONFIG_CSH_INBUFF
+#define CONFIG_CSH_INBUFF 0
+#endif
+
+/*!< read input in place from port ring by peek and commit callbacks */
+#ifndef CONFIG_CSH_PEEK
+#define CONFIG_CSH_PEEK 0
+#endif
+
+/*!< key to echo latency and echo bytes statistics, needs stamp callback */
+#ifndef CONFIG_CSH_STATS
+#define CONFIG_CSH_STATS 0
+#endif
+
+/*!< typeahead queue size kept while command runs, must be power of 2, 0 to disable */
+#ifndef CONFIG_CSH_TYPEAHEAD
+#define CONFIG_CSH_TYPEAHEAD 0
+#endif
+
+/*!< pager for command output, search line buffer size, 0 to disable (single thread only) */
+#ifndef CONFIG_CSH_PAGER
+#define CONFIG_CSH_PAGER 0
+#endif
+
 /*!< help information */
 #ifndef CONFIG_CSH_HELP
 #define CONFIG_CSH_HELP ""
@@ -159,6 +244,13 @@
 #define CONFIG_READLINE_DFTROW         CONFIG_CSH_DFTROW
 #define CONFIG_READLINE_DFTCOL         CONFIG_CSH_DFTCOL
 #define CONFIG_READLINE_HISTORY        CONFIG_CSH_HISTORY
+#define CONFIG_READLINE_HISTORY_DEPTH  CONFIG_CSH_HISTORY_DEPTH
+#define CONFIG_READLINE_HISTORY_DEDUP  CONFIG_CSH_HISTORY_DEDUP
+#define CONFIG_READLINE_HISTORY_SEARCH CONFIG_CSH_HISTORY_SEARCH
+#define CONFIG_READLINE_HISTORY_PREFIX CONFIG_CSH_HISTORY_PREFIX
+#define CONFIG_READLINE_HISTORY_STORE  CONFIG_CSH_HISTORY_STORE
+#define CONFIG_READLINE_HISTORY_PACK   CONFIG_CSH_HISTORY_PACK
+#define CONFIG_READLINE_HISTORY_EXPAND CONFIG_CSH_HISTORY_EXPAND
 #define CONFIG_READLINE_COMPLETION     CONFIG_CSH_COMPLETION
 #define CONFIG_READLINE_MAX_COMPLETION CONFIG_CSH_MAX_COMPLETION
 #define CONFIG_READLINE_PROMPTEDIT     CONFIG_CSH_PROMPTEDIT
@@ -170,6 +262,16 @@
 #define CONFIG_READLINE_ALTMAP         CONFIG_CSH_ALTMAP
 #define CONFIG_READLINE_REFRESH_PROMPT CONFIG_CSH_REFRESH_PROMPT
 #define CONFIG_READLINE_NOBLOCK        CONFIG_CSH_NOBLOCK
+#define CONFIG_READLINE_TXQUEUE        CONFIG_CSH_TXQUEUE
+#define CONFIG_READLINE_PASTE          CONFIG_CSH_PASTE
+#define CONFIG_READLINE_BATCH          CONFIG_CSH_BATCH
+#define CONFIG_READLINE_ESC_TIMEOUT    CONFIG_CSH_ESC_TIMEOUT
+#define CONFIG_READLINE_LEAN           CONFIG_CSH_LEAN
+#define CONFIG_READLINE_INBUFF         CONFIG_CSH_INBUFF
+#define CONFIG_READLINE_PEEK           CONFIG_CSH_PEEK
+#define CONFIG_READLINE_STATS          CONFIG_CSH_STATS
+#define CONFIG_READLINE_TYPEAHEAD      CONFIG_CSH_TYPEAHEAD
+#define CONFIG_READLINE_PAGER          CONFIG_CSH_PAGER
 #define CONFIG_READLINE_HELP           CONFIG_CSH_HELP
 
 #include "cherryrl/chry_readline.h"
@@ -19,6 +19,27 @@
 /*!< history support <+550byte> */
 #define CONFIG_CSH_HISTORY 1
 
+/*!< max history entries, indexed by offset (use 2 x depth byte), must be power of 2 */
+#define CONFIG_CSH_HISTORY_DEPTH 32
+
+/*!< history duplicate check, 0:off 1:skip same as last 2:also erase older copies */
+#define CONFIG_CSH_HISTORY_DEDUP 1
+
+/*!< reverse history search on ctrl-r, max pattern length, 0:off */
+#define CONFIG_CSH_HISTORY_SEARCH 0
+
+/*!< up and down only visit history starting with text before cursor */
+#define CONFIG_CSH_HISTORY_PREFIX 0
+
+/*!< history storage callbacks, stored history is loaded on first browse */
+#define CONFIG_CSH_HISTORY_STORE 0
+
+/*!< history prefix compression, entries store only the suffix after prefix shared with the older one */
+#define CONFIG_CSH_HISTORY_PACK 0
+
+/*!< history expansion at line start, !! !-n and !prefix */
+#define CONFIG_CSH_HISTORY_EXPAND 0
+
 /*!< completion support <+1100byte> */
 #define CONFIG_CSH_COMPLETION 1
 
@@ -52,6 +73,36 @@
 /*!< no waiting for sget */
 #define CONFIG_CSH_NOBLOCK 1
 
+/*!< transmit queue size, must be a power of 2, 0 to disable, not with multi-thread */
+#define CONFIG_CSH_TXQUEUE 0
+
+/*!< bracketed paste, pasted text is inserted with one refresh */
+#define CONFIG_CSH_PASTE 0
+
+/*!< max edits applied per refresh while input is pending, 0 to disable */
+#define CONFIG_CSH_BATCH 0
+
+/*!< lone esc timeout in ms, needs clock callback, 0 to disable */
+#define CONFIG_CSH_ESC_TIMEOUT 0
+
+/*!< lean wire mode, SGR can be dropped from output at runtime */
+#define CONFIG_CSH_LEAN 0
+
+/*!< input buffer size, refilled by one sget call, 0 to disable */
+#define CONFIG_CSH_INBUFF 0
+
+/*!< read input in place from port ring by peek and commit callbacks */
+#define CONFIG_CSH_PEEK 0
+
+/*!< key to echo latency and echo bytes statistics, needs stamp callback */
+#define CONFIG_CSH_STATS 0
+
+/*!< typeahead queue size kept while command runs, must be power of 2, 0 to disable */
+#define CONFIG_CSH_TYPEAHEAD 0
+
+/*!< pager for command output, search line buffer size, 0 to disable (single thread only) */
+#define CONFIG_CSH_PAGER 0
+
 /*!< help information */
 #define CONFIG_CSH_HELP ""
 
@@ -41,6 +41,12 @@ static uint16_t csh_sget_cb(chry_readline_t *rl, void *data, uint16_t size)
     return chry_ringbuffer_read(&shell_rb, data, size);
 }
 
+static uint16_t csh_savail_cb(chry_readline_t *rl)
+{
+    (void)rl;
+    return chry_ringbuffer_get_used(&shell_rb) ? 1 : 0;
+}
+
 int shell_init(UART_Type *uart, bool need_login)
 {
     chry_shell_init_t csh_init;
@@ -117,6 +123,9 @@ int shell_init(UART_Type *uart, bool need_login)
         return -1;
     }
 
+    /*!< pending input hint, lets typeahead share one refresh */
+    chry_readline_set_avail_cb(&csh.rl, csh_savail_cb);
+
     return 0;
 }
 
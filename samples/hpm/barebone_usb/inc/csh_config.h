@@ -52,6 +52,9 @@
 /*!< no waiting for sget */
 #define CONFIG_CSH_NOBLOCK 1
 
+/*!< read input in place from port ring by peek and commit callbacks */
+#define CONFIG_CSH_PEEK 1
+
 /*!< help information */
 #define CONFIG_CSH_HELP ""
 
@@ -193,6 +193,24 @@ static uint16_t csh_sget_cb(chry_readline_t *rl, void *data, uint16_t size)
     return chry_ringbuffer_read(&shell_rb, data, size);
 }
 
+static const uint8_t *csh_speek_cb(chry_readline_t *rl, uint16_t *size)
+{
+    uint32_t linear;
+    void *data;
+    (void)rl;
+
+    /*!< decode straight from ringbuffer memory, no copy */
+    data = chry_ringbuffer_linear_read_setup(&shell_rb, &linear);
+    *size = linear > 0xffff ? 0xffff : linear;
+    return data;
+}
+
+static void csh_scommit_cb(chry_readline_t *rl, uint16_t size)
+{
+    (void)rl;
+    chry_ringbuffer_linear_read_done(&shell_rb, size);
+}
+
 int shell_init(uint8_t busid, uint32_t regbase, bool need_login)
 {
     chry_shell_init_t csh_init;
@@ -269,6 +287,9 @@ int shell_init(uint8_t busid, uint32_t regbase, bool need_login)
         return -1;
     }
 
+    /*!< in place input, CONFIG_CSH_PEEK is enabled in csh_config.h */
+    chry_readline_set_peek_cb(&csh.rl, csh_speek_cb, csh_scommit_cb);
+
     return 0;
 }
 
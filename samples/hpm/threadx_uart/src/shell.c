@@ -202,13 +202,13 @@ void chry_shell_port_default_handler(chry_shell_t *csh, int sig)
     /*!< force delete thread */
     if (thread_exec_created) {
         if (TX_SUCCESS != tx_thread_terminate(&thread_buffer_exec)) {
-            csh->rl.sput(&csh->rl, "context terminate error" CONFIG_CSH_NEWLINE CONFIG_CSH_NEWLINE,
-                         23 + (sizeof(CONFIG_CSH_NEWLINE) ? (sizeof(CONFIG_CSH_NEWLINE) - 1) * 2 : 0));
+            chry_readline_write(&csh->rl, "context terminate error" CONFIG_CSH_NEWLINE CONFIG_CSH_NEWLINE,
+                                23 + (sizeof(CONFIG_CSH_NEWLINE) ? (sizeof(CONFIG_CSH_NEWLINE) - 1) * 2 : 0));
             return;
         }
         if (TX_SUCCESS != tx_thread_delete(&thread_buffer_exec)) {
-            csh->rl.sput(&csh->rl, "context delete error" CONFIG_CSH_NEWLINE CONFIG_CSH_NEWLINE,
-                         20 + (sizeof(CONFIG_CSH_NEWLINE) ? (sizeof(CONFIG_CSH_NEWLINE) - 1) * 2 : 0));
+            chry_readline_write(&csh->rl, "context delete error" CONFIG_CSH_NEWLINE CONFIG_CSH_NEWLINE,
+                                20 + (sizeof(CONFIG_CSH_NEWLINE) ? (sizeof(CONFIG_CSH_NEWLINE) - 1) * 2 : 0));
             return;
         }
         thread_exec_created = false;
@@ -216,16 +216,16 @@ void chry_shell_port_default_handler(chry_shell_t *csh, int sig)
 
     switch (sig) {
         case CSH_SIGINT:
-            csh->rl.sput(&csh->rl, "^SIGINT" CONFIG_CSH_NEWLINE, sizeof("^SIGINT" CONFIG_CSH_NEWLINE) - 1);
+            chry_readline_write(&csh->rl, "^SIGINT" CONFIG_CSH_NEWLINE, sizeof("^SIGINT" CONFIG_CSH_NEWLINE) - 1);
             break;
         case CSH_SIGQUIT:
-            csh->rl.sput(&csh->rl, "^SIGQUIT" CONFIG_CSH_NEWLINE, sizeof("^SIGQUIT" CONFIG_CSH_NEWLINE) - 1);
+            chry_readline_write(&csh->rl, "^SIGQUIT" CONFIG_CSH_NEWLINE, sizeof("^SIGQUIT" CONFIG_CSH_NEWLINE) - 1);
             break;
         case CSH_SIGKILL:
-            csh->rl.sput(&csh->rl, "^SIGKILL" CONFIG_CSH_NEWLINE, sizeof("^SIGKILL" CONFIG_CSH_NEWLINE) - 1);
+            chry_readline_write(&csh->rl, "^SIGKILL" CONFIG_CSH_NEWLINE, sizeof("^SIGKILL" CONFIG_CSH_NEWLINE) - 1);
             break;
         case CSH_SIGTERM:
-            csh->rl.sput(&csh->rl, "^SIGTERM" CONFIG_CSH_NEWLINE, sizeof("^SIGTERM" CONFIG_CSH_NEWLINE) - 1);
+            chry_readline_write(&csh->rl, "^SIGTERM" CONFIG_CSH_NEWLINE, sizeof("^SIGTERM" CONFIG_CSH_NEWLINE) - 1);
             break;
         default:
             return;